@@ -0,0 +1,213 @@
+/**********************************************
+ * NeoCompositor.cpp
+ *
+ *  Blends NeoArr layers into one output array. Blending works on whole 32 bit
+ *  words of the frame with two channels per word in 16 bit lanes, so mixing by
+ *  opacity costs four multiplies for every four channel values.
+ */
+
+#include "NeoCompositor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LANES   0x00FF00FF      // even bytes of a word, one per 16 bit lane
+
+
+// mixes two words of channel values, a = 0 keeps d and a = 256 gives t
+static uint32_t mixWord(uint32_t d, uint32_t t, uint32_t a)
+{
+    uint32_t e = (((d & LANES) * (256 - a) + (t & LANES) * a) >> 8) & LANES;
+    uint32_t o = ((((d >> 8) & LANES) * (256 - a) + ((t >> 8) & LANES) * a) >> 8) & LANES;
+    return e | (o << 8);
+}
+
+// adds s scaled by a to d, saturating each channel at 255
+static uint32_t addWord(uint32_t d, uint32_t s, uint32_t a)
+{
+    uint32_t e = (d & LANES) + ((((s & LANES) * a) >> 8) & LANES);
+    uint32_t o = ((d >> 8) & LANES) + (((((s >> 8) & LANES) * a) >> 8) & LANES);
+    uint32_t ce = e & 0x01000100;       // lanes that went past 255
+    uint32_t co = o & 0x01000100;
+    e = (e | (ce - (ce >> 8))) & LANES;
+    o = (o | (co - (co >> 8))) & LANES;
+    return e | (o << 8);
+}
+
+// multiplies the four channel values of two words, 255 being 1.0
+static uint32_t mulWord(uint32_t d, uint32_t s)
+{
+    uint32_t r = 0;
+    for (int k = 0; k < 32; k += 8)
+    {
+        uint32_t v = ((d >> k) & 0xFF) * ((s >> k) & 0xFF) + 128;
+        r |= ((v + (v >> 8)) >> 8) << k;    // exact division by 255
+    }
+    return r;
+}
+
+
+void NeoCompositor::Layer::write(const NeoColor *px, int n)
+{
+    this->px = (const uint8_t*)px;
+    if (n > this->n)
+        this->n = n;
+    if (n > size)
+        size = n;       // NeoArr sends its whole chain on the first write
+}
+
+NeoCompositor::NeoCompositor(NeoArr *out, int N, int layers) : out(out)
+{
+    count = (layers > NEO_MAX_LAYERS) ? NEO_MAX_LAYERS : layers;
+    size = N * 64;
+    split = 0;
+    for (int i = 0; i < count; i++)
+    {
+        arrays[i] = new NeoArr(&this->layers[i], N);
+        arrays[i]->setBrightness(1.0f);     // layers pass their colors through unchanged
+        arrays[i]->setGamma(1.0f);
+        opacity[i] = 255;
+        mode[i] = NEO_BLEND_ALPHA;
+        key[i].red = key[i].green = key[i].blue = 0;
+    }
+
+    cache = (uint8_t*)malloc(size * 3);
+    result = (uint8_t*)malloc(size * 3);
+    if (cache == NULL || result == NULL)
+    {
+        printf("NeoCompositor: ERROR unable to malloc layer buffers");
+        size = 0;
+        return;
+    }
+    memset(cache, 0, size * 3);
+}
+
+NeoCompositor::~NeoCompositor()
+{
+    for (int i = 0; i < count; i++)
+        delete arrays[i];
+    free(cache);
+    free(result);
+}
+
+NeoArr *NeoCompositor::layer(int i)
+{
+    if (i < 0 || i >= count)
+        return NULL;
+    return arrays[i];
+}
+
+void NeoCompositor::setOpacity(int i, uint8_t opacity)
+{
+    if (i < 0 || i >= count || this->opacity[i] == opacity)
+        return;
+    this->opacity[i] = opacity;
+    layers[i].n = layers[i].size;       // the whole layer comes out different
+}
+
+void NeoCompositor::setBlend(int i, int mode)
+{
+    if (i < 0 || i >= count || this->mode[i] == mode)
+        return;
+    this->mode[i] = mode;
+    layers[i].n = layers[i].size;
+}
+
+void NeoCompositor::setKey(int i, int color)
+{
+    if (i < 0 || i >= count)
+        return;
+    key[i].red = (color >> 16) & 0xFF;
+    key[i].green = (color >> 8) & 0xFF;
+    key[i].blue = color & 0xFF;
+    if (mode[i] == NEO_BLEND_KEY)
+        layers[i].n = layers[i].size;
+}
+
+// blends the first n pixels of layer i into dst
+void NeoCompositor::blend(uint8_t *dst, int i, int n) const
+{
+    if (layers[i].px == NULL || opacity[i] == 0)
+        return;
+
+    uint32_t *d = (uint32_t*)dst;
+    const uint32_t *s = (const uint32_t*)layers[i].px;
+    uint32_t a = opacity[i] + (opacity[i] >> 7);       // 0 to 256
+    int words = (n * 3 + 3) / 4;                        // frames are a whole number of words
+
+    switch (mode[i])
+    {
+        case NEO_BLEND_KEY:
+        {
+            // note: pixels do not line up with words, so this goes a pixel at a time
+            const NeoColor *p = (const NeoColor*)layers[i].px;
+            NeoColor *q = (NeoColor*)dst;
+            const NeoColor &k = key[i];
+            for (int j = 0; j < n; j++)
+            {
+                if (p[j].green == k.green && p[j].red == k.red && p[j].blue == k.blue)
+                    continue;
+                q[j].green = (q[j].green * (256 - a) + p[j].green * a) >> 8;
+                q[j].red = (q[j].red * (256 - a) + p[j].red * a) >> 8;
+                q[j].blue = (q[j].blue * (256 - a) + p[j].blue * a) >> 8;
+            }
+            break;
+        }
+        case NEO_BLEND_ADD:
+            for (int w = 0; w < words; w++)
+                d[w] = addWord(d[w], s[w], a);
+            break;
+        case NEO_BLEND_MULTIPLY:
+            for (int w = 0; w < words; w++)
+                d[w] = mixWord(d[w], mulWord(d[w], s[w]), a);
+            break;
+        case NEO_BLEND_SCREEN:
+            for (int w = 0; w < words; w++)
+                d[w] = mixWord(d[w], ~mulWord(~d[w], ~s[w]), a);    // 1 - (1-d)(1-s)
+            break;
+        default:
+            if (a == 256)
+                memcpy(d, s, words * 4);
+            else
+                for (int w = 0; w < words; w++)
+                    d[w] = mixWord(d[w], s[w], a);
+            break;
+    }
+}
+
+void NeoCompositor::write()
+{
+    for (int i = 0; i < count; i++)
+        arrays[i]->write();         // hands each changed layer to its Layer sink
+
+    int low = count;                // lowest layer that changed
+    int n = 0;                      // pixels that may come out different
+    for (int i = count - 1; i >= 0; i--)
+        if (layers[i].n > 0)
+        {
+            low = i;
+            if (layers[i].n > n)
+                n = layers[i].n;
+        }
+
+    if (low < count && size > 0)
+    {
+        // bring the cache up to the lowest changed layer
+        if (low < split)
+        {
+            memset(cache, 0, size * 3);
+            split = 0;
+        }
+        for (; split < low; split++)
+            blend(cache, split, size);
+
+        memcpy(result, cache, n * 3);
+        for (int i = split; i < count; i++)
+            blend(result, i, n);
+
+        for (int i = 0; i < count; i++)
+            layers[i].n = 0;
+        out->writeSpan(0, 0, 0, (const NeoColor*)result, n);
+    }
+    out->write();
+}
@@ -0,0 +1,117 @@
+/**
+ * NeoCompositor.h
+ *
+ * Stacks several NeoArr layers (for example a background, an effect and overlaid
+ * text) and blends them into the NeoArr that drives the strip. Each layer keeps
+ * its own pixels, so one layer can be redrawn without touching the others.
+ *
+ * Each layer is a full NeoArr that writes to the compositor; NeoArr::write() on a
+ * layer only records its frame and NeoCompositor::write() blends the layers that
+ * changed and writes the result out.
+ *
+ * NEO_BLEND_ALPHA covers the whole frame of a layer, black pixels included. An
+ * overlay such as text on a cleared layer uses NEO_BLEND_KEY instead, which
+ * leaves the pixels of a key color transparent.
+ *
+ */
+
+#ifndef NEOCOMPOSITOR_H
+#define NEOCOMPOSITOR_H
+
+#include "NeoMatrix.h"
+
+// blend modes for NeoCompositor::setBlend()
+#define NEO_BLEND_ALPHA     0   // the layer covers what is below, mixed by its opacity; every pixel covers, black too
+#define NEO_BLEND_ADD       1   // the layer is added to what is below, black leaves it as it is
+#define NEO_BLEND_MULTIPLY  2   // what is below is darkened by the layer, white leaves it as it is
+#define NEO_BLEND_SCREEN    3   // what is below is lightened by the layer, black leaves it as it is
+#define NEO_BLEND_KEY       4   // as NEO_BLEND_ALPHA, but pixels of the layer's key color show what is below
+
+#define NEO_MAX_LAYERS      4
+
+/**
+ * A stack of layers blended into one NeoArr
+ */
+class NeoCompositor
+{
+    public:
+        /**
+         * Create a NeoCompositor. Every layer starts opaque with NEO_BLEND_ALPHA,
+         * and layer 0 is blended over black.
+         *
+         * @param out The array that shows the result; its brightness, gamma and dither apply to the blended frame
+         * @param N The number of 8x8 boards, the same as for out
+         * @param layers The number of layers, up to 4
+         */
+        NeoCompositor(NeoArr *out, int N, int layers);
+        ~NeoCompositor();
+
+        /**
+         * Returns the array to draw layer i with; layer 0 is at the bottom. Give it
+         * the same layout as the output array.
+         */
+        NeoArr *layer(int i);
+
+        /**
+         * Sets how strongly layer i shows
+         *
+         * @param i The layer
+         * @param opacity 0 hides the layer, 255 shows it fully
+         */
+        void setOpacity(int i, uint8_t opacity);
+
+        /**
+         * Sets how layer i is combined with the layers below it
+         *
+         * @param i The layer
+         * @param mode One of the NEO_BLEND values
+         */
+        void setBlend(int i, int mode);
+
+        /**
+         * Sets the color of layer i that NEO_BLEND_KEY leaves transparent, so text
+         * or sprites drawn on a cleared layer sit over the layers below it
+         *
+         * @param i The layer
+         * @param color The transparent color, black (0) to begin with
+         */
+        void setKey(int i, int color);
+
+        /**
+         * Blends the layers that changed since the last call and writes the result
+         * to the output array. Layers below the lowest one that changed are kept
+         * blended from earlier frames and are not blended again.
+         */
+        void write();
+
+    protected:
+        /**
+         * Records the frame of one layer for NeoCompositor
+         */
+        class Layer : public NeoSink
+        {
+            public:
+                Layer() : px(NULL), n(0), size(0) {}
+                virtual void write(const NeoColor *px, int n);
+
+                const uint8_t *px;      // last frame of this layer
+                int n;                  // pixels that changed since the last composite
+                int size;               // pixels in this layer
+        };
+
+        NeoArr *out;
+        NeoArr *arrays[NEO_MAX_LAYERS];
+        Layer layers[NEO_MAX_LAYERS];
+        uint8_t opacity[NEO_MAX_LAYERS];
+        uint8_t mode[NEO_MAX_LAYERS];
+        NeoColor key[NEO_MAX_LAYERS];   // transparent color of each layer for NEO_BLEND_KEY
+        int count;          // layers in use
+        int size;           // pixels in each layer
+        int split;          // cache holds the layers below this one blended together
+        uint8_t *cache;     // blend of the layers below split
+        uint8_t *result;    // blend of every layer, written to out
+
+        void blend(uint8_t *dst, int i, int n) const;
+};
+
+#endif
@@ -0,0 +1,83 @@
+/**********************************************
+ * NeoDither.cpp
+ *
+ *  Temporal and ordered dithering of the output of NeoArr. Both run on the 8.8
+ *  fixed point output table with one add and one shift per channel.
+ */
+
+#include "NeoDither.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// 8x8 Bayer matrix, indexed by the position of the pixel inside its board (x*8 + y)
+static const uint8_t bayer[64] = {
+     0, 48, 12, 60,  3, 51, 15, 63,
+    32, 16, 44, 28, 35, 19, 47, 31,
+     8, 56,  4, 52, 11, 59,  7, 55,
+    40, 24, 36, 20, 43, 27, 39, 23,
+     2, 50, 14, 62,  1, 49, 13, 61,
+    34, 18, 46, 30, 33, 17, 45, 29,
+    10, 58,  6, 54,  9, 57,  5, 53,
+    42, 26, 38, 22, 41, 25, 37, 21
+};
+
+NeoDither::NeoDither(int n, int mode) : size(n), mode(mode)
+{
+    err = NULL;
+    if (!temporal())
+        return;
+
+    err = (uint8_t*)malloc(n * 3);
+    if (err == NULL)
+    {
+        printf("NeoDither: ERROR unable to malloc error buffer");
+        size = 0;
+        return;
+    }
+
+    // with ordered dithering as well, neighbouring pixels start at different
+    // phases so they do not all step up on the same frame
+    for (int i = 0; i < n * 3; i++)
+        err[i] = (mode & NEO_DITHER_ORDERED) ? bayer[(i / 3) & 63] * 4 + 2 : 0x80;
+}
+
+NeoDither::~NeoDither()
+{
+    free(err);
+}
+
+int NeoDither::render(const NeoColor *src, NeoColor *dst, int n, const uint16_t *lut)
+{
+    const uint8_t *in = (const uint8_t*)src;
+    uint8_t *out = (uint8_t*)dst;
+    int last = -1;
+
+    if (temporal())
+    {
+        if (n > size)
+            n = size;
+        for (int i = 0; i < n * 3; i++)
+        {
+            unsigned v = lut[in[i]] + err[i];
+            err[i] = v;             // keep the fraction for the next frame
+            if (out[i] != (uint8_t)(v >> 8))
+            {
+                out[i] = v >> 8;
+                last = i;
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; i < n * 3; i++)
+        {
+            unsigned v = lut[in[i]] + bayer[(i / 3) & 63] * 4 + 2;
+            if (out[i] != (uint8_t)(v >> 8))
+            {
+                out[i] = v >> 8;
+                last = i;
+            }
+        }
+    }
+    return (last + 3) / 3;      // last counts bytes and is -1 when nothing changed
+}
@@ -0,0 +1,58 @@
+/**
+ * NeoDither.h
+ *
+ * Dithering stage between the pixel buffer and the sink. The brightness and gamma
+ * table gives each channel 8 fractional bits; dithering spreads that fraction
+ * over frames (temporal) or over neighbouring pixels (ordered) so low brightness
+ * settings keep smooth color steps.
+ *
+ */
+
+#ifndef NEODITHER_H
+#define NEODITHER_H
+
+#include "NeoSink.h"
+
+// dither modes for NeoArr::setDither(), may be combined
+#define NEO_DITHER_OFF          0
+#define NEO_DITHER_TEMPORAL     1   // carry each pixel's rounding error into the next frame
+#define NEO_DITHER_ORDERED      2   // 8x8 Bayer threshold per board pixel
+
+/**
+ * Per pixel dither state for one chain
+ */
+class NeoDither
+{
+    public:
+        /**
+         * Create a NeoDither
+         *
+         * @param n The number of pixels in the chain
+         * @param mode NEO_DITHER_TEMPORAL, NEO_DITHER_ORDERED or both
+         */
+        NeoDither(int n, int mode);
+        ~NeoDither();
+
+        /**
+         * Maps pixels through the output table and dithers them into dst
+         *
+         * @param src The full brightness pixels
+         * @param dst The output pixels, compared with the new values
+         * @param n The number of pixels to render
+         * @param lut Output value of each channel value in 8.8 fixed point
+         * @returns One past the last pixel of dst that changed
+         */
+        int render(const NeoColor *src, NeoColor *dst, int n, const uint16_t *lut);
+
+        /**
+         * Returns true if the output changes every frame even when the pixels do not
+         */
+        bool temporal() const { return (mode & NEO_DITHER_TEMPORAL) != 0; }
+
+    protected:
+        uint8_t *err;       // fractional part carried to the next frame, 3 per pixel
+        int size;           // pixels in err
+        int mode;           // NEO_DITHER flags
+};
+
+#endif
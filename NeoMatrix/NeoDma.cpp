@@ -0,0 +1,180 @@
+/**********************************************
+ * NeoDma.cpp
+ *
+ *  DMA output for NeoArr. NeoEncoder turns the frame into SPI bytes and the
+ *  DMA engine feeds them to the SSP, so the strip is driven without any CPU
+ *  time during output.
+ */
+
+#include "NeoDma.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+void NeoSimDmaEngine::start(const uint8_t *src, int n)
+{
+    this->src = src;
+    len = n;
+    pos = 0;
+    count++;
+    if (n == 0)
+        complete();
+}
+
+bool NeoSimDmaEngine::busy() const
+{
+    if (rate > 0 && pos < len)
+        const_cast<NeoSimDmaEngine*>(this)->step(rate);    // the transfer runs while the CPU polls
+    return pos < len;
+}
+
+int NeoSimDmaEngine::step(int n)
+{
+    if (n > len - pos)
+        n = len - pos;
+    if (n <= 0)
+        return 0;
+    pos += n;
+    if (pos == len)
+        complete();
+    return n;
+}
+
+
+#ifdef TARGET_LPC1768
+
+#define NEO_DMA_BLOCK       4095        // largest GPDMA transfer size
+#define NEO_DMA_CONTROL     ((1 << 12) | (1 << 15) | (1 << 26))    // burst 4, byte wide, source increment
+#define NEO_DMA_TC_IRQ      (1UL << 31)
+
+NeoGpdmaEngine *NeoGpdmaEngine::instance = NULL;
+
+NeoGpdmaEngine::NeoGpdmaEngine(PinName mosi) :
+    spi(mosi, NC, (mosi == p11) ? p13 : p7), lli(NULL), nlli(0), running(false)
+{
+    spi.format(8, 0);
+    spi.frequency(NEO_ENCODER_HZ_3BIT);
+
+    ssp = (mosi == p11) ? LPC_SSP0 : LPC_SSP1;
+    request = (mosi == p11) ? 0 : 2;        // SSP0 Tx / SSP1 Tx request lines
+    ssp->DMACR |= 2;                        // let the transmit FIFO request DMA
+
+    LPC_SC->PCONP |= (1 << 29);             // power up the GPDMA
+    LPC_GPDMA->DMACConfig = 1;              // enable, little endian
+    LPC_GPDMA->DMACIntTCClear = 1;
+    LPC_GPDMA->DMACIntErrClr = 1;
+
+    instance = this;
+    NVIC_SetVector(DMA_IRQn, (uint32_t)&NeoGpdmaEngine::irq);
+    NVIC_EnableIRQ(DMA_IRQn);
+}
+
+NeoGpdmaEngine::~NeoGpdmaEngine()
+{
+    NVIC_DisableIRQ(DMA_IRQn);
+    LPC_GPDMACH0->DMACCConfig = 0;
+    instance = NULL;
+    free(lli);
+}
+
+void NeoGpdmaEngine::frequency(int hz)
+{
+    while (running);
+    spi.frequency(hz);
+}
+
+void NeoGpdmaEngine::start(const uint8_t *src, int n)
+{
+    while (running);    // one transfer at a time
+
+    int blocks = (n + NEO_DMA_BLOCK - 1) / NEO_DMA_BLOCK;
+    if (blocks > nlli)
+    {
+        free(lli);
+        lli = (Lli*)malloc(blocks * sizeof(Lli));
+        nlli = (lli == NULL) ? 0 : blocks;
+        if (lli == NULL)
+        {
+            printf("NeoGpdmaEngine: ERROR unable to malloc DMA list");
+            return;
+        }
+    }
+
+    // build the linked list; the first entry is loaded straight into the channel
+    for (int i = 0; i < blocks; i++)
+    {
+        int len = n - i * NEO_DMA_BLOCK;
+        if (len > NEO_DMA_BLOCK)
+            len = NEO_DMA_BLOCK;
+        lli[i].src = (uint32_t)(src + i * NEO_DMA_BLOCK);
+        lli[i].dst = (uint32_t)&ssp->DR;
+        lli[i].next = (i + 1 < blocks) ? (uint32_t)&lli[i + 1] : 0;
+        lli[i].control = len | NEO_DMA_CONTROL | ((i + 1 == blocks) ? NEO_DMA_TC_IRQ : 0);
+    }
+
+    running = true;
+    LPC_GPDMA->DMACIntTCClear = 1;
+    LPC_GPDMA->DMACIntErrClr = 1;
+    LPC_GPDMACH0->DMACCSrcAddr = lli[0].src;
+    LPC_GPDMACH0->DMACCDestAddr = lli[0].dst;
+    LPC_GPDMACH0->DMACCLLI = lli[0].next;
+    LPC_GPDMACH0->DMACCControl = lli[0].control;
+    LPC_GPDMACH0->DMACCConfig = 1                   // enable
+                              | (request << 6)      // destination peripheral
+                              | (1 << 11)           // memory to peripheral
+                              | (1 << 14)           // error interrupt
+                              | (1 << 15);          // terminal count interrupt
+}
+
+void NeoGpdmaEngine::irq()
+{
+    uint32_t tc = LPC_GPDMA->DMACIntTCStat & 1;
+    uint32_t err = LPC_GPDMA->DMACIntErrStat & 1;
+    LPC_GPDMA->DMACIntTCClear = tc;
+    LPC_GPDMA->DMACIntErrClr = err;
+    if ((tc || err) && instance)
+    {
+        instance->running = false;
+        instance->complete();
+    }
+}
+
+#endif
+
+
+NeoDmaSink::NeoDmaSink(NeoDmaEngine *engine, int n, int bits) : engine(engine), enc(bits), size(n)
+{
+    buf = (uint8_t*)malloc(enc.length(n));
+    if (buf == NULL)
+    {
+        printf("NeoDmaSink: ERROR unable to malloc SPI buffer");
+        size = 0;
+    }
+    if (!enc.valid())
+        printf("NeoDmaSink: WARNING pulse widths at %dHz are outside the WS2812 timing", enc.frequency());
+
+    engine->frequency(enc.frequency());
+    engine->attach(&NeoDmaSink::finished, this);
+}
+
+NeoDmaSink::~NeoDmaSink()
+{
+    while (engine->busy());
+    engine->attach(NULL, NULL);
+    free(buf);
+}
+
+void NeoDmaSink::write(const NeoColor *px, int n)
+{
+    if (n > size)
+        n = size;
+
+    while (engine->busy());     // the buffer still belongs to the last frame
+
+    engine->start(buf, enc.encode(px, n, buf));
+}
+
+void NeoDmaSink::finished(void *sink)
+{
+    ((NeoDmaSink*)sink)->complete();
+}
@@ -0,0 +1,178 @@
+/**
+ * NeoDma.h
+ *
+ * Non-blocking output for NeoArr. The frame is turned into an SPI bit pattern
+ * by NeoEncoder, and a DMA engine streams that pattern to the SPI data register
+ * while the CPU carries on drawing the next frame.
+ *
+ */
+
+#ifndef NEODMA_H
+#define NEODMA_H
+
+#include "NeoSink.h"
+#include "NeoEncoder.h"
+
+/**
+ * A DMA channel that copies a byte buffer to an SPI transmitter
+ */
+class NeoDmaEngine
+{
+    public:
+        NeoDmaEngine() : done(NULL), arg(NULL) {}
+        virtual ~NeoDmaEngine() {}
+
+        /**
+         * Start streaming a buffer. The buffer must stay untouched until busy()
+         * returns false.
+         *
+         * @param src The bytes to send
+         * @param n The number of bytes in src
+         */
+        virtual void start(const uint8_t *src, int n) = 0;
+
+        /**
+         * Returns true while a transfer is running
+         */
+        virtual bool busy() const = 0;
+
+        /**
+         * Set the SPI bit clock used for the following transfers
+         *
+         * The base engine ignores the rate; engines that drive an SPI clock
+         * override this.
+         */
+        virtual void frequency(int) {}
+
+        /**
+         * Attach a function to be called when a transfer finishes
+         *
+         * @param fn The function to call
+         * @param arg The argument passed to fn
+         */
+        void attach(void (*fn)(void*), void *arg) { done = fn; this->arg = arg; }
+
+    protected:
+        void (*done)(void*);    // completion callback
+        void *arg;              // argument for done
+
+        // called by the engine once the last byte has been handed to the SPI
+        void complete() { if (done) done(arg); }
+};
+
+/**
+ * Software model of a DMA engine for host builds. By default nothing moves
+ * until step() or finish() is called, which lets a test inspect the sink while
+ * a transfer is in flight.
+ */
+class NeoSimDmaEngine : public NeoDmaEngine
+{
+    public:
+        /**
+         * Create a NeoSimDmaEngine
+         *
+         * @param rate Bytes moved each time busy() is polled, 0 to move only on step()
+         */
+        NeoSimDmaEngine(int rate = 0) : src(NULL), len(0), pos(0), count(0), rate(rate) {}
+
+        virtual void start(const uint8_t *src, int n);
+        virtual bool busy() const;
+
+        /**
+         * Move up to n bytes of the running transfer
+         *
+         * @returns The number of bytes moved
+         */
+        int step(int n);
+
+        /**
+         * Move the rest of the running transfer
+         */
+        void finish() { step(len - pos); }
+
+        const uint8_t *data() const { return src; }    // buffer of the last transfer
+        int length() const { return len; }             // bytes in the last transfer
+        int transfers() const { return count; }        // number of start() calls
+
+    protected:
+        const uint8_t *src;     // buffer being sent
+        int len;                // bytes in src
+        int pos;                // bytes already sent
+        int count;              // number of transfers started
+        int rate;               // bytes moved per busy() poll
+};
+
+#ifdef TARGET_LPC1768
+/**
+ * GPDMA channel 0 feeding SSP0 or SSP1 on the LPC1768. Transfers longer than
+ * one DMA block (4095 bytes) are split with a linked list.
+ */
+class NeoGpdmaEngine : public NeoDmaEngine
+{
+    public:
+        /**
+         * Create a NeoGpdmaEngine
+         *
+         * @param mosi The SPI data pin the strip is connected to (p5 or p11)
+         */
+        NeoGpdmaEngine(PinName mosi);
+        virtual ~NeoGpdmaEngine();
+
+        virtual void start(const uint8_t *src, int n);
+        virtual bool busy() const { return running; }
+        virtual void frequency(int hz);
+
+    protected:
+        struct Lli
+        {
+            uint32_t src;
+            uint32_t dst;
+            uint32_t next;
+            uint32_t control;
+        };
+
+        SPI spi;                    // sets up the pin and bit clock
+        LPC_SSP_TypeDef *ssp;       // SSP the pin belongs to
+        int request;                // DMA request line of the SSP transmitter
+        Lli *lli;                   // linked list for long transfers
+        int nlli;                   // entries allocated in lli
+        volatile bool running;      // true until the terminal count interrupt
+
+        static NeoGpdmaEngine *instance;
+        static void irq();
+};
+#endif
+
+/**
+ * Sink that encodes each frame for SPI and sends it through a NeoDmaEngine.
+ * write() only waits if the previous frame is still going out.
+ */
+class NeoDmaSink : public NeoSink
+{
+    public:
+        /**
+         * Create a NeoDmaSink
+         *
+         * @param engine The DMA engine used to send the encoded frame
+         * @param n The largest number of pixels in a frame
+         * @param bits The number of SPI bits per LED bit, 3 or 4
+         */
+        NeoDmaSink(NeoDmaEngine *engine, int n, int bits = 3);
+        virtual ~NeoDmaSink();
+
+        virtual void write(const NeoColor *px, int n);
+        virtual bool busy() const { return engine->busy(); }
+
+        const uint8_t *data() const { return buf; }     // encoded bit pattern of the last frame
+        const NeoEncoder &encoder() const { return enc; }
+
+    protected:
+        NeoDmaEngine *engine;   // DMA engine used for output
+        NeoEncoder enc;         // pixel to SPI pattern encoder
+        uint8_t *buf;           // encoded frame followed by the reset pulse
+        int size;               // capacity of buf in pixels
+
+        static void finished(void *sink);
+};
+
+#endif
@@ -0,0 +1,103 @@
+/**********************************************
+ * NeoEncoder.cpp
+ *
+ *  WS2812 to SPI bit pattern encoder. A 256 entry table holds the SPI bytes for
+ *  every possible data byte, and the kernel assembles whole 32 bit words from it
+ *  so each data byte costs one load and a couple of shifts.
+ *
+ *  The word stores assume a little endian core, as on the LPC1768.
+ */
+
+#include "NeoEncoder.h"
+#include <string.h>
+
+
+NeoEncoder::NeoEncoder(int bits, int hz)
+{
+    this->bits = (bits == 4) ? 4 : 3;
+    if (hz <= 0)
+        hz = (this->bits == 4) ? NEO_ENCODER_HZ_4BIT : NEO_ENCODER_HZ_3BIT;
+    this->hz = hz;
+
+    // hold the line low a little longer than the minimum reset time
+    long long resetBits = (long long)hz * (NEO_TRESET + 10000) / 1000000000;
+    reset = (int)((resetBits + 7) / 8);
+
+    uint32_t zero = (this->bits == 4) ? 0x8 : 0x4;     // 1000 or 100
+    uint32_t one = (this->bits == 4) ? 0xC : 0x6;      // 1100 or 110
+
+    for (int v = 0; v < 256; v++)
+    {
+        uint32_t pattern = 0;   // SPI bit stream, first bit in the top bit
+        for (int bit = 7; bit >= 0; bit--)
+            pattern = (pattern << this->bits) | (((v >> bit) & 1) ? one : zero);
+
+        // reorder so that a little endian store puts the first SPI byte first
+        uint32_t word = 0;
+        for (int k = 0; k < this->bits; k++)
+            word |= ((pattern >> (8 * (this->bits - 1 - k))) & 0xFF) << (8 * k);
+        table[v] = word;
+    }
+}
+
+int NeoEncoder::encode(const NeoColor *px, int n, uint8_t *out) const
+{
+    const uint8_t *in = (const uint8_t*)px;
+    int bytes = n * 3;
+    int i = 0;
+    uint32_t *w = (uint32_t*)out;
+
+    if (bits == 4)
+    {
+        for (; i < bytes; i++)      // one data byte is exactly one word
+            *w++ = table[in[i]];
+    }
+    else
+    {
+        for (; i + 4 <= bytes; i += 4)  // four data bytes pack into three words
+        {
+            uint32_t a = table[in[i]];
+            uint32_t b = table[in[i + 1]];
+            uint32_t c = table[in[i + 2]];
+            uint32_t d = table[in[i + 3]];
+            w[0] = a | (b << 24);
+            w[1] = (b >> 8) | (c << 16);
+            w[2] = (c >> 16) | (d << 8);
+            w += 3;
+        }
+    }
+
+    uint8_t *o = (uint8_t*)w;
+    for (; i < bytes; i++)      // leftover bytes of the 3 bit packing
+    {
+        uint32_t t = table[in[i]];
+        *o++ = t;
+        *o++ = t >> 8;
+        *o++ = t >> 16;
+    }
+
+    memset(o, 0, reset);
+    return bytes * bits + reset;
+}
+
+int NeoEncoder::t0h() const
+{
+    return (int)(1000000000LL / hz);
+}
+
+int NeoEncoder::t1h() const
+{
+    return (int)(2000000000LL / hz);
+}
+
+int NeoEncoder::tbit() const
+{
+    return (int)(bits * 1000000000LL / hz);
+}
+
+bool NeoEncoder::valid() const
+{
+    return t0h() >= NEO_T0H_MIN && t0h() <= NEO_T0H_MAX
+        && t1h() >= NEO_T1H_MIN && t1h() <= NEO_T1H_MAX
+        && tbit() >= NEO_TBIT_MIN && tbit() <= NEO_TBIT_MAX;
+}
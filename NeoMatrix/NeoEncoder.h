@@ -0,0 +1,78 @@
+/**
+ * NeoEncoder.h
+ *
+ * Converts the GRB pixel buffer into the bit pattern an SSP clocks out to the
+ * strip. Every WS2812 bit becomes 3 or 4 SPI bits with the high part at the
+ * front (100/110 or 1000/1100), so the pulse timing comes from the SPI clock
+ * instead of calibrated delay loops.
+ *
+ */
+
+#ifndef NEOENCODER_H
+#define NEOENCODER_H
+
+#include "NeoSink.h"
+
+#define NEO_ENCODER_HZ_3BIT     2400000     // 417ns per SPI bit, 1.25us per LED bit
+#define NEO_ENCODER_HZ_4BIT     3000000     // 333ns per SPI bit, 1.33us per LED bit
+
+// WS2812/WS2812B timing windows in ns, taken wide enough to cover both parts
+#define NEO_T0H_MIN     200
+#define NEO_T0H_MAX     500
+#define NEO_T1H_MIN     550
+#define NEO_T1H_MAX     950
+#define NEO_TBIT_MIN    650
+#define NEO_TBIT_MAX    1850
+#define NEO_TRESET      50000
+
+/**
+ * Table driven WS2812 to SPI encoder
+ */
+class NeoEncoder
+{
+    public:
+        /**
+         * Create a NeoEncoder
+         *
+         * @param bits The number of SPI bits per LED bit, 3 or 4
+         * @param hz The SPI bit clock, 0 for the default rate of the chosen width
+         */
+        NeoEncoder(int bits = 3, int hz = 0);
+
+        /**
+         * Encode pixels into SPI bytes followed by the reset pulse
+         *
+         * @param px The pixel data in chain order
+         * @param n The number of pixels in px
+         * @param out Word aligned output with room for length(n) bytes
+         * @returns The number of bytes written to out
+         */
+        int encode(const NeoColor *px, int n, uint8_t *out) const;
+
+        /**
+         * Returns the number of bytes encode() writes for n pixels
+         */
+        int length(int n) const { return n * bytesPerPixel() + resetBytes(); }
+
+        int bitsPerBit() const { return bits; }
+        int bytesPerPixel() const { return 3 * bits; }  // 24 LED bits, bits SPI bits each
+        int resetBytes() const { return reset; }
+        int frequency() const { return hz; }
+
+        int t0h() const;        // high time of a zero in ns
+        int t1h() const;        // high time of a one in ns
+        int tbit() const;       // length of one LED bit in ns
+
+        /**
+         * Returns true if the pulse widths at this SPI clock are inside the WS2812 windows
+         */
+        bool valid() const;
+
+    protected:
+        int bits;               // SPI bits per LED bit
+        int hz;                 // SPI bit clock
+        int reset;              // zero bytes needed for the reset pulse
+        uint32_t table[256];    // SPI pattern for each byte value, first byte in the low bits
+};
+
+#endif
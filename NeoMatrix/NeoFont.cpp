@@ -0,0 +1,127 @@
+/**********************************************
+ * NeoFont.cpp
+ *
+ *  Lookups into the packed NeoFont tables, and UTF-8 decoding for the text
+ *  drawn with them.
+ */
+
+#include "NeoFont.h"
+
+
+const NeoGlyph &neo_font_glyph(const NeoFont &font, uint32_t c)
+{
+    if (c >= font.first && c <= font.last)
+        return font.glyphs[c - font.first];
+
+    // binary search of the characters after last
+    int lo = 0;
+    int hi = font.sparse - 1;
+    while (lo <= hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (font.codes[mid] == c)
+            return font.glyphs[font.last - font.first + 1 + mid];
+        if (font.codes[mid] < c)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+
+    // note: bdf2neo makes the fallback one of the font's characters, so this does not recurse again
+    return neo_font_glyph(font, font.fallback);
+}
+
+uint32_t neo_font_column(const NeoFont &font, const NeoGlyph &glyph, int col)
+{
+    // a column of up to 16 bits starting anywhere in a byte lies within three bytes
+    uint32_t bit = glyph.offset + col * font.height;
+    const uint8_t *p = font.bitmap + (bit >> 3);
+    uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+    return (v >> (bit & 7)) & ((1 << font.height) - 1);
+}
+
+int neo_font_kern(const NeoFont &font, uint32_t left, uint32_t right)
+{
+    if (left > 0xFFFF || right > 0xFFFF)
+        return 0;
+
+    // binary search of the sorted pairs
+    int lo = 0;
+    int hi = font.kerns - 1;
+    uint32_t key = (left << 16) | right;
+    while (lo <= hi)
+    {
+        int mid = (lo + hi) / 2;
+        uint32_t k = (font.kerning[mid].left << 16) | font.kerning[mid].right;
+        if (k == key)
+            return font.kerning[mid].adjust;
+        if (k < key)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return 0;
+}
+
+int neo_text_width(const NeoFont &font, const char *text)
+{
+    int width = 0;
+    uint32_t c = neo_utf8_next(text);
+    while (c)
+    {
+        uint32_t next = neo_utf8_next(text);
+        width += neo_font_glyph(font, c).advance;
+        if (next)
+            width += neo_font_kern(font, c, next);
+        c = next;
+    }
+    return width;
+}
+
+uint32_t neo_utf8_next(const char *&text)
+{
+    const uint8_t *p = (const uint8_t*)text;
+    uint32_t c = p[0];
+    if (c == 0)
+        return 0;
+
+    // the number of continuation bytes and the smallest code point that needs them
+    int n = 0;
+    uint32_t min = 0;
+    if ((c & 0xE0) == 0xC0)
+    {
+        n = 1;
+        min = 0x80;
+        c &= 0x1F;
+    }
+    else if ((c & 0xF0) == 0xE0)
+    {
+        n = 2;
+        min = 0x800;
+        c &= 0x0F;
+    }
+    else if ((c & 0xF8) == 0xF0)
+    {
+        n = 3;
+        min = 0x10000;
+        c &= 0x07;
+    }
+
+    for (int i = 1; i <= n; i++)
+    {
+        if ((p[i] & 0xC0) != 0x80)
+        {
+            // not UTF-8 (a stray or cut off sequence, or Latin-1 text), so take the byte on its own
+            text++;
+            return p[0];
+        }
+        c = (c << 6) | (p[i] & 0x3F);
+    }
+    if (c < min || c > 0x10FFFF)
+    {
+        text++;
+        return p[0];
+    }
+    text += n + 1;
+    return c;
+}
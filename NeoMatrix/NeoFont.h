@@ -0,0 +1,99 @@
+/**
+ * NeoFont.h
+ *
+ * Proportional bitmap fonts for NeoArr::drawText(). A NeoFont only points at its
+ * tables, which tools/bdf2neo generates from a BDF font as const arrays, so the
+ * whole font is packed at compile time and stays in flash.
+ *
+ * Each glyph is stored as its inked columns only, every column height bits with
+ * bit 0 at the bottom, packed one after another into the bitmap with no padding.
+ *
+ * Characters are Unicode code points up to U+FFFF, and text is UTF-8. The glyphs
+ * of first to last are indexed directly; characters beyond them (symbols, other
+ * scripts) are found by a binary search of a sorted table of code points.
+ *
+ */
+
+#ifndef NEOFONT_H
+#define NEOFONT_H
+
+#include "NeoSink.h"
+
+#define NEO_FONT_MAX_HEIGHT 16      // tallest font the packed columns can hold
+
+/**
+ * Where one glyph is in the bitmap and how it is placed
+ */
+typedef struct _NeoGlyph
+{
+    uint16_t offset;            // bit of the bitmap the first column starts at
+    uint8_t width;              // columns stored, 0 for a blank glyph
+    int8_t left;                // columns from the pen position to the first stored column
+    uint8_t advance;            // columns the pen moves on after the glyph
+} NeoGlyph;
+
+/**
+ * A change to the advance between two characters
+ */
+typedef struct _NeoKern
+{
+    uint16_t left;              // character drawn first
+    uint16_t right;             // character drawn after it
+    int8_t adjust;              // columns added to the advance of left
+} NeoKern;
+
+/**
+ * A proportional font
+ */
+typedef struct _NeoFont
+{
+    const uint8_t *bitmap;      // packed columns, followed by two bytes of padding
+    const NeoGlyph *glyphs;     // one for each character from first to last, then one for each of codes
+    const uint16_t *codes;      // sorted characters after last, NULL if none
+    uint16_t sparse;            // characters in codes
+    const NeoKern *kerning;     // pairs sorted by left and then right, NULL if none
+    uint16_t kerns;             // pairs in kerning
+    uint16_t first;             // first directly indexed character
+    uint16_t last;              // last directly indexed character
+    uint16_t fallback;          // character drawn for those not in the font
+    uint8_t height;             // rows of every glyph, up to NEO_FONT_MAX_HEIGHT
+} NeoFont;
+
+/**
+ * BMplain from font.h with each glyph trimmed to its inked columns and one
+ * blank column after it, with Latin-1 and a few symbols added
+ */
+extern const NeoFont neo_font_plain;
+
+/**
+ * Returns the glyph of a character, or of the font's fallback character when
+ * the font does not have it
+ */
+const NeoGlyph &neo_font_glyph(const NeoFont &font, uint32_t c);
+
+/**
+ * Returns column col of a glyph, bit 0 at the bottom
+ */
+uint32_t neo_font_column(const NeoFont &font, const NeoGlyph &glyph, int col);
+
+/**
+ * Returns the kerning between two characters, 0 if the pair has none
+ */
+int neo_font_kern(const NeoFont &font, uint32_t left, uint32_t right);
+
+/**
+ * Returns the number of columns the pen moves on over a UTF-8 string
+ */
+int neo_text_width(const NeoFont &font, const char *text);
+
+/**
+ * Decodes the UTF-8 character at text and moves text past it. A byte that does
+ * not start a valid sequence is taken as a Latin-1 character on its own, so
+ * 8 bit strings still draw.
+ *
+ * @param text The string, moved on by one character unless at its end
+ * @returns The code point, 0 at the end of the string
+ */
+uint32_t neo_utf8_next(const char *&text);
+
+#endif
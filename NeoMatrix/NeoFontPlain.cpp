@@ -0,0 +1,335 @@
+/**********************************************
+ * neo_font_plain
+ *
+ *  Generated by tools/bdf2neo from tools/bmplain.bdf; do not edit.
+ */
+
+#include "NeoFont.h"
+
+static const uint8_t neo_font_plain_bitmap[899] = {
+    0x74, 0xc0, 0x00, 0xc0, 0x50, 0xf8, 0x50, 0xf8, 0x50, 0x74, 0x54, 0xd6,
+    0x54, 0x5c, 0x70, 0x54, 0x78, 0x10, 0x3c, 0x54, 0x7c, 0x54, 0x54, 0x44,
+    0x1c, 0x10, 0xc0, 0x38, 0x44, 0x44, 0x38, 0xa8, 0x70, 0x20, 0x70, 0xa8,
+    0x10, 0x10, 0x7c, 0x10, 0x10, 0x06, 0x10, 0x10, 0x10, 0x10, 0x10, 0x04,
+    0x04, 0x08, 0x10, 0x20, 0x40, 0x7c, 0x44, 0x54, 0x44, 0x7c, 0x20, 0x7c,
+    0x5c, 0x54, 0x54, 0x54, 0x74, 0x54, 0x54, 0x54, 0x54, 0x7c, 0x70, 0x10,
+    0x10, 0x10, 0x7c, 0x74, 0x54, 0x54, 0x54, 0x5c, 0x7c, 0x54, 0x54, 0x54,
+    0x5c, 0x40, 0x40, 0x40, 0x40, 0x7c, 0x7c, 0x54, 0x54, 0x54, 0x7c, 0x74,
+    0x54, 0x54, 0x54, 0x7c, 0x28, 0x2c, 0x10, 0x28, 0x44, 0x28, 0x28, 0x28,
+    0x28, 0x28, 0x44, 0x28, 0x10, 0x60, 0x40, 0x54, 0x50, 0x70, 0x7c, 0x40,
+    0x5c, 0x54, 0x7c, 0x7c, 0x48, 0x48, 0x48, 0x7c, 0x7c, 0x54, 0x54, 0x54,
+    0x6c, 0x7c, 0x44, 0x44, 0x44, 0x44, 0x7c, 0x44, 0x44, 0x44, 0x38, 0x7c,
+    0x54, 0x54, 0x54, 0x44, 0x7c, 0x50, 0x50, 0x50, 0x40, 0x7c, 0x44, 0x54,
+    0x54, 0x5c, 0x7c, 0x10, 0x10, 0x10, 0x7c, 0x44, 0x7c, 0x44, 0x1c, 0x04,
+    0x04, 0x04, 0x7c, 0x7c, 0x10, 0x10, 0x28, 0x44, 0x7c, 0x04, 0x04, 0x04,
+    0x04, 0x7c, 0x20, 0x1c, 0x20, 0x7c, 0x7c, 0x20, 0x10, 0x08, 0x7c, 0x7c,
+    0x44, 0x44, 0x44, 0x7c, 0x7c, 0x50, 0x50, 0x50, 0x70, 0x7c, 0x44, 0x4e,
+    0x44, 0x7c, 0x7c, 0x50, 0x50, 0x58, 0x74, 0x74, 0x54, 0x54, 0x54, 0x5c,
+    0x40, 0x40, 0x7c, 0x40, 0x40, 0x78, 0x04, 0x04, 0x04, 0x78, 0x70, 0x08,
+    0x04, 0x08, 0x70, 0x7c, 0x08, 0x70, 0x08, 0x7c, 0x44, 0x28, 0x10, 0x28,
+    0x44, 0x40, 0x20, 0x1c, 0x20, 0x40, 0x5c, 0x54, 0x54, 0x54, 0x74, 0x7c,
+    0x44, 0xfc, 0x84, 0xfc, 0x44, 0x7c, 0x30, 0x78, 0x3c, 0x78, 0x30, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x38, 0x7c, 0x7c, 0x7c, 0x38, 0x3c, 0x24, 0x24,
+    0x24, 0x3c, 0x04, 0x7c, 0x24, 0x24, 0x24, 0x3c, 0x3c, 0x24, 0x24, 0x24,
+    0x24, 0x3c, 0x24, 0x24, 0x24, 0x7c, 0x3c, 0x24, 0x2c, 0x34, 0x24, 0x10,
+    0x7c, 0x50, 0x50, 0x38, 0x2a, 0x2a, 0x2a, 0x3e, 0x7c, 0x20, 0x20, 0x20,
+    0x3c, 0x5c, 0x04, 0x02, 0x5e, 0x7c, 0x10, 0x28, 0x44, 0x40, 0x7c, 0x3c,
+    0x20, 0x3c, 0x20, 0x3c, 0x3c, 0x20, 0x20, 0x20, 0x3c, 0x3c, 0x24, 0x24,
+    0x24, 0x3c, 0x3e, 0x24, 0x24, 0x24, 0x3c, 0x3c, 0x24, 0x24, 0x24, 0x3e,
+    0x3c, 0x20, 0x20, 0x20, 0x24, 0x34, 0x2c, 0x24, 0x20, 0x7c, 0x24, 0x24,
+    0x3c, 0x04, 0x04, 0x04, 0x3c, 0x30, 0x08, 0x04, 0x08, 0x30, 0x3c, 0x04,
+    0x3c, 0x04, 0x3c, 0x24, 0x24, 0x18, 0x24, 0x24, 0x38, 0x0a, 0x0a, 0x0a,
+    0x3e, 0x24, 0x2c, 0x34, 0x24, 0x10, 0x7c, 0x44, 0x38, 0x44, 0x44, 0x44,
+    0x38, 0x44, 0x7c, 0x10, 0x80, 0x80, 0x80, 0x2e, 0x3c, 0x24, 0x7e, 0x24,
+    0x24, 0x14, 0x3c, 0x54, 0x44, 0x04, 0x44, 0x38, 0x28, 0x38, 0x44, 0x54,
+    0x34, 0x1e, 0x34, 0x54, 0x6c, 0x7d, 0x55, 0x5f, 0x40, 0x00, 0x40, 0x7c,
+    0x44, 0x7c, 0x6c, 0x7c, 0xb4, 0xd4, 0xf4, 0x10, 0x28, 0x10, 0x28, 0x20,
+    0x20, 0x20, 0x38, 0x10, 0x10, 0x10, 0x7c, 0x44, 0x54, 0x6c, 0x7c, 0x80,
+    0x80, 0x80, 0xe0, 0xa0, 0xe0, 0x24, 0x24, 0x74, 0x24, 0x24, 0x90, 0xb0,
+    0x50, 0x90, 0xd0, 0x60, 0x40, 0x80, 0x3f, 0x04, 0x04, 0x04, 0x3c, 0x60,
+    0x70, 0x7c, 0x40, 0x7c, 0x10, 0x01, 0x03, 0x80, 0xf0, 0xe8, 0xa8, 0xe8,
+    0x28, 0x10, 0x28, 0x10, 0xe4, 0x08, 0x10, 0x28, 0x58, 0x04, 0xe4, 0x08,
+    0x10, 0x34, 0x5c, 0xa4, 0xe8, 0x10, 0x28, 0x58, 0x04, 0x1c, 0x14, 0x54,
+    0x04, 0x0c, 0x7c, 0xc8, 0xc8, 0x48, 0x7c, 0x7c, 0x48, 0xc8, 0xc8, 0x7c,
+    0x7c, 0xc8, 0xc8, 0xc8, 0x7c, 0x7c, 0xc8, 0xc8, 0x48, 0xfc, 0x7c, 0xc8,
+    0x48, 0xc8, 0x7c, 0x7c, 0x48, 0xc8, 0x48, 0x7c, 0x7c, 0x50, 0x50, 0x7c,
+    0x54, 0x54, 0x54, 0x7c, 0x45, 0x47, 0x44, 0x44, 0x7c, 0xd4, 0xd4, 0x54,
+    0x44, 0x7c, 0x54, 0xd4, 0xd4, 0x44, 0x7c, 0xd4, 0xd4, 0xd4, 0x44, 0x7c,
+    0xd4, 0x54, 0xd4, 0x44, 0xc4, 0x7c, 0x44, 0x44, 0x7c, 0xc4, 0xc4, 0xfc,
+    0xc4, 0xc4, 0x7c, 0xc4, 0x10, 0x7c, 0x54, 0x44, 0x44, 0x38, 0x7c, 0xa0,
+    0x90, 0x08, 0xfc, 0x7c, 0xc4, 0xc4, 0x44, 0x7c, 0x7c, 0x44, 0xc4, 0xc4,
+    0x7c, 0x7c, 0xc4, 0xc4, 0xc4, 0x7c, 0x7c, 0xc4, 0xc4, 0x44, 0xfc, 0x7c,
+    0xc4, 0x44, 0xc4, 0x7c, 0x22, 0x14, 0x08, 0x14, 0x22, 0x7c, 0x4c, 0x54,
+    0x64, 0x38, 0x78, 0x84, 0x84, 0x04, 0x78, 0x78, 0x04, 0x84, 0x84, 0x78,
+    0x78, 0x84, 0x84, 0x84, 0x78, 0x78, 0x84, 0x04, 0x84, 0x78, 0x40, 0x20,
+    0x9c, 0xa0, 0x40, 0x7c, 0x28, 0x28, 0x28, 0x10, 0x7e, 0x54, 0x54, 0x54,
+    0x28, 0x3c, 0xa4, 0x64, 0x24, 0x3c, 0x04, 0x3c, 0x24, 0x64, 0xa4, 0x3c,
+    0x04, 0x3c, 0x64, 0xa4, 0x64, 0x3c, 0x04, 0x7c, 0xa4, 0xa4, 0x64, 0xbc,
+    0x04, 0x3c, 0x64, 0x24, 0x64, 0x3c, 0x04, 0x3c, 0xe4, 0xa4, 0xe4, 0x3c,
+    0x04, 0x3c, 0x24, 0x24, 0x3c, 0x2c, 0x2c, 0x3c, 0x3c, 0x25, 0x27, 0x24,
+    0x24, 0x3c, 0xa4, 0x6c, 0x34, 0x24, 0x3c, 0x24, 0x6c, 0xb4, 0x24, 0x3c,
+    0x64, 0xac, 0x74, 0x24, 0x3c, 0x64, 0x2c, 0x74, 0x24, 0x80, 0x5c, 0x5c,
+    0x80, 0x40, 0x9c, 0x40, 0x40, 0x1c, 0x40, 0x1c, 0x54, 0x34, 0x54, 0x3c,
+    0x7c, 0xa0, 0xa0, 0x60, 0xbc, 0x3c, 0xa4, 0x64, 0x24, 0x3c, 0x3c, 0x24,
+    0x64, 0xa4, 0x3c, 0x3c, 0x64, 0xa4, 0x64, 0x3c, 0x7c, 0xa4, 0xa4, 0x64,
+    0xbc, 0x3c, 0x64, 0x24, 0x64, 0x3c, 0x10, 0x10, 0x54, 0x10, 0x10, 0x3e,
+    0x24, 0x2c, 0x34, 0x3c, 0x40, 0x3c, 0x84, 0x44, 0x04, 0x3c, 0x3c, 0x04,
+    0x44, 0x84, 0x3c, 0x3c, 0x44, 0x84, 0x44, 0x3c, 0x3c, 0x44, 0x04, 0x44,
+    0x3c, 0x38, 0x0a, 0x4a, 0x8a, 0x3e, 0x7f, 0x24, 0x24, 0x24, 0x3c, 0x38,
+    0x4a, 0x0a, 0x4a, 0x3e, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+    0x10, 0x10, 0x60, 0xa0, 0xa0, 0xc0, 0x60, 0xa0, 0x60, 0xa0, 0xa0, 0xc0,
+    0xa0, 0xc0, 0x10, 0x38, 0x10, 0x04, 0x00, 0x04, 0x00, 0x04, 0x28, 0x38,
+    0x6c, 0x6c, 0x44, 0x10, 0x38, 0x54, 0x10, 0x10, 0x10, 0x20, 0x7c, 0x20,
+    0x10, 0x10, 0x10, 0x54, 0x38, 0x10, 0x10, 0x08, 0x7c, 0x08, 0x10, 0x70,
+    0x78, 0x3c, 0x78, 0x70, 0x0c, 0x0c, 0x7c, 0x40, 0x20, 0x00, 0x00,
+};
+
+static const NeoGlyph neo_font_plain_glyphs[239] = {
+    {    0,  0,  0,  3},     // ' '
+    {    0,  1,  0,  2},     // '!'
+    {    8,  3,  0,  4},     // '"'
+    {   32,  5,  0,  6},     // '#'
+    {   72,  5,  0,  6},     // '$'
+    {  112,  6,  0,  7},     // '%'
+    {  160,  6,  0,  7},     // '&'
+    {  208,  1,  0,  2},     // 0x0027
+    {  216,  2,  0,  3},     // '('
+    {  232,  2,  0,  3},     // ')'
+    {  248,  5,  0,  6},     // '*'
+    {  288,  5,  0,  6},     // '+'
+    {  328,  1,  0,  2},     // ','
+    {  336,  5,  0,  6},     // '-'
+    {  376,  1,  0,  2},     // '.'
+    {  384,  5,  0,  6},     // '/'
+    {  424,  5,  0,  6},     // '0'
+    {  464,  2,  0,  3},     // '1'
+    {  480,  5,  0,  6},     // '2'
+    {  520,  5,  0,  6},     // '3'
+    {  560,  5,  0,  6},     // '4'
+    {  600,  5,  0,  6},     // '5'
+    {  640,  5,  0,  6},     // '6'
+    {  680,  5,  0,  6},     // '7'
+    {  720,  5,  0,  6},     // '8'
+    {  760,  5,  0,  6},     // '9'
+    {  800,  1,  0,  2},     // ':'
+    {  808,  1,  0,  2},     // ';'
+    {  816,  3,  0,  4},     // '<'
+    {  840,  5,  0,  6},     // '='
+    {  880,  3,  0,  4},     // '>'
+    {  904,  5,  0,  6},     // '?'
+    {  944,  5,  0,  6},     // '@'
+    {  984,  5,  0,  6},     // 'A'
+    { 1024,  5,  0,  6},     // 'B'
+    { 1064,  5,  0,  6},     // 'C'
+    { 1104,  5,  0,  6},     // 'D'
+    { 1144,  5,  0,  6},     // 'E'
+    { 1184,  5,  0,  6},     // 'F'
+    { 1224,  5,  0,  6},     // 'G'
+    { 1264,  5,  0,  6},     // 'H'
+    { 1304,  3,  0,  4},     // 'I'
+    { 1328,  5,  0,  6},     // 'J'
+    { 1368,  5,  0,  6},     // 'K'
+    { 1408,  5,  0,  6},     // 'L'
+    { 1448,  5,  0,  6},     // 'M'
+    { 1488,  5,  0,  6},     // 'N'
+    { 1528,  5,  0,  6},     // 'O'
+    { 1568,  5,  0,  6},     // 'P'
+    { 1608,  5,  0,  6},     // 'Q'
+    { 1648,  5,  0,  6},     // 'R'
+    { 1688,  5,  0,  6},     // 'S'
+    { 1728,  5,  0,  6},     // 'T'
+    { 1768,  5,  0,  6},     // 'U'
+    { 1808,  5,  0,  6},     // 'V'
+    { 1848,  5,  0,  6},     // 'W'
+    { 1888,  5,  0,  6},     // 'X'
+    { 1928,  5,  0,  6},     // 'Y'
+    { 1968,  5,  0,  6},     // 'Z'
+    { 2008,  2,  0,  3},     // '['
+    { 2024,  3,  0,  4},     // 0x005c
+    { 2048,  2,  0,  3},     // ']'
+    { 2064,  5,  0,  6},     // '^'
+    { 2104,  5,  0,  6},     // '_'
+    { 2144,  5,  0,  6},     // '`'
+    { 2184,  6,  0,  7},     // 'a'
+    { 2232,  5,  0,  6},     // 'b'
+    { 2272,  5,  0,  6},     // 'c'
+    { 2312,  5,  0,  6},     // 'd'
+    { 2352,  5,  0,  6},     // 'e'
+    { 2392,  4,  0,  5},     // 'f'
+    { 2424,  5,  0,  6},     // 'g'
+    { 2464,  5,  0,  6},     // 'h'
+    { 2504,  1,  0,  2},     // 'i'
+    { 2512,  3,  0,  4},     // 'j'
+    { 2536,  4,  0,  5},     // 'k'
+    { 2568,  2,  0,  3},     // 'l'
+    { 2584,  5,  0,  6},     // 'm'
+    { 2624,  5,  0,  6},     // 'n'
+    { 2664,  5,  0,  6},     // 'o'
+    { 2704,  5,  0,  6},     // 'p'
+    { 2744,  5,  0,  6},     // 'q'
+    { 2784,  4,  0,  5},     // 'r'
+    { 2816,  4,  0,  5},     // 's'
+    { 2848,  4,  0,  5},     // 't'
+    { 2880,  5,  0,  6},     // 'u'
+    { 2920,  5,  0,  6},     // 'v'
+    { 2960,  5,  0,  6},     // 'w'
+    { 3000,  5,  0,  6},     // 'x'
+    { 3040,  5,  0,  6},     // 'y'
+    { 3080,  4,  0,  5},     // 'z'
+    { 3112,  3,  0,  4},     // '{'
+    { 3136,  5,  0,  6},     // '|'
+    { 3176,  3,  0,  4},     // '}'
+    { 3200,  3,  0,  4},     // '~'
+    { 3224,  0,  0,  3},     // 0x007f
+    {  904,  5,  0,  6},     // 0x0080
+    {  904,  5,  0,  6},     // 0x0081
+    {  904,  5,  0,  6},     // 0x0082
+    {  904,  5,  0,  6},     // 0x0083
+    {  904,  5,  0,  6},     // 0x0084
+    {  904,  5,  0,  6},     // 0x0085
+    {  904,  5,  0,  6},     // 0x0086
+    {  904,  5,  0,  6},     // 0x0087
+    {  904,  5,  0,  6},     // 0x0088
+    {  904,  5,  0,  6},     // 0x0089
+    {  904,  5,  0,  6},     // 0x008a
+    {  904,  5,  0,  6},     // 0x008b
+    {  904,  5,  0,  6},     // 0x008c
+    {  904,  5,  0,  6},     // 0x008d
+    {  904,  5,  0,  6},     // 0x008e
+    {  904,  5,  0,  6},     // 0x008f
+    {  904,  5,  0,  6},     // 0x0090
+    {  904,  5,  0,  6},     // 0x0091
+    {  904,  5,  0,  6},     // 0x0092
+    {  904,  5,  0,  6},     // 0x0093
+    {  904,  5,  0,  6},     // 0x0094
+    {  904,  5,  0,  6},     // 0x0095
+    {  904,  5,  0,  6},     // 0x0096
+    {  904,  5,  0,  6},     // 0x0097
+    {  904,  5,  0,  6},     // 0x0098
+    {  904,  5,  0,  6},     // 0x0099
+    {  904,  5,  0,  6},     // 0x009a
+    {  904,  5,  0,  6},     // 0x009b
+    {  904,  5,  0,  6},     // 0x009c
+    {  904,  5,  0,  6},     // 0x009d
+    {  904,  5,  0,  6},     // 0x009e
+    {  904,  5,  0,  6},     // 0x009f
+    { 3224,  0,  0,  3},     // 0x00a0
+    { 3224,  1,  0,  2},     // 0x00a1
+    { 3232,  5,  0,  6},     // 0x00a2
+    { 3272,  5,  0,  6},     // 0x00a3
+    { 3312,  5,  0,  6},     // 0x00a4
+    { 3352,  5,  0,  6},     // 0x00a5
+    { 3392,  1,  0,  2},     // 0x00a6
+    { 3400,  3,  1,  5},     // 0x00a7
+    { 3424,  3,  0,  4},     // 0x00a8
+    { 3448,  5,  0,  6},     // 0x00a9
+    { 3488,  3,  0,  4},     // 0x00aa
+    { 3512,  4,  0,  5},     // 0x00ab
+    { 3544,  4,  0,  5},     // 0x00ac
+    { 3576,  3,  0,  4},     // 0x00ad
+    { 3600,  5,  0,  6},     // 0x00ae
+    { 3640,  3,  0,  4},     // 0x00af
+    { 3664,  3,  0,  4},     // 0x00b0
+    { 3688,  5,  0,  6},     // 0x00b1
+    { 3728,  3,  0,  4},     // 0x00b2
+    { 3752,  3,  0,  4},     // 0x00b3
+    { 3776,  2,  0,  3},     // 0x00b4
+    { 3792,  5,  0,  6},     // 0x00b5
+    { 3832,  5,  0,  6},     // 0x00b6
+    { 3872,  1,  0,  2},     // 0x00b7
+    { 3880,  2,  0,  3},     // 0x00b8
+    { 3896,  2,  0,  3},     // 0x00b9
+    { 3912,  3,  0,  4},     // 0x00ba
+    { 3936,  4,  1,  6},     // 0x00bb
+    { 3968,  6,  0,  7},     // 0x00bc
+    { 4016,  5,  0,  6},     // 0x00bd
+    { 4056,  6,  0,  7},     // 0x00be
+    { 4104,  5,  0,  6},     // 0x00bf
+    { 4144,  5,  0,  6},     // 0x00c0
+    { 4184,  5,  0,  6},     // 0x00c1
+    { 4224,  5,  0,  6},     // 0x00c2
+    { 4264,  5,  0,  6},     // 0x00c3
+    { 4304,  5,  0,  6},     // 0x00c4
+    { 4344,  5,  0,  6},     // 0x00c5
+    { 4384,  7,  0,  8},     // 0x00c6
+    { 4440,  5,  0,  6},     // 0x00c7
+    { 4480,  5,  0,  6},     // 0x00c8
+    { 4520,  5,  0,  6},     // 0x00c9
+    { 4560,  5,  0,  6},     // 0x00ca
+    { 4600,  5,  0,  6},     // 0x00cb
+    { 4640,  3,  0,  4},     // 0x00cc
+    { 4664,  3,  0,  4},     // 0x00cd
+    { 4688,  3,  0,  4},     // 0x00ce
+    { 4712,  3,  0,  4},     // 0x00cf
+    { 4736,  6,  0,  7},     // 0x00d0
+    { 4784,  5,  0,  6},     // 0x00d1
+    { 4824,  5,  0,  6},     // 0x00d2
+    { 4864,  5,  0,  6},     // 0x00d3
+    { 4904,  5,  0,  6},     // 0x00d4
+    { 4944,  5,  0,  6},     // 0x00d5
+    { 4984,  5,  0,  6},     // 0x00d6
+    { 5024,  5,  0,  6},     // 0x00d7
+    { 5064,  5,  1,  7},     // 0x00d8
+    { 5104,  5,  0,  6},     // 0x00d9
+    { 5144,  5,  0,  6},     // 0x00da
+    { 5184,  5,  0,  6},     // 0x00db
+    { 5224,  5,  0,  6},     // 0x00dc
+    { 5264,  5,  0,  6},     // 0x00dd
+    { 5304,  5,  0,  6},     // 0x00de
+    { 5344,  5,  0,  6},     // 0x00df
+    { 5384,  6,  0,  7},     // 0x00e0
+    { 5432,  6,  0,  7},     // 0x00e1
+    { 5480,  6,  0,  7},     // 0x00e2
+    { 5528,  6,  0,  7},     // 0x00e3
+    { 5576,  6,  0,  7},     // 0x00e4
+    { 5624,  6,  0,  7},     // 0x00e5
+    { 5672,  7,  0,  8},     // 0x00e6
+    { 5728,  5,  0,  6},     // 0x00e7
+    { 5768,  5,  0,  6},     // 0x00e8
+    { 5808,  5,  0,  6},     // 0x00e9
+    { 5848,  5,  0,  6},     // 0x00ea
+    { 5888,  5,  0,  6},     // 0x00eb
+    { 5928,  2,  0,  3},     // 0x00ec
+    { 5944,  2,  1,  4},     // 0x00ed
+    { 5960,  3,  0,  4},     // 0x00ee
+    { 5984,  3,  0,  4},     // 0x00ef
+    { 6008,  5,  0,  6},     // 0x00f0
+    { 6048,  5,  0,  6},     // 0x00f1
+    { 6088,  5,  0,  6},     // 0x00f2
+    { 6128,  5,  0,  6},     // 0x00f3
+    { 6168,  5,  0,  6},     // 0x00f4
+    { 6208,  5,  0,  6},     // 0x00f5
+    { 6248,  5,  0,  6},     // 0x00f6
+    { 6288,  5,  0,  6},     // 0x00f7
+    { 6328,  6,  0,  7},     // 0x00f8
+    { 6376,  5,  0,  6},     // 0x00f9
+    { 6416,  5,  0,  6},     // 0x00fa
+    { 6456,  5,  0,  6},     // 0x00fb
+    { 6496,  5,  0,  6},     // 0x00fc
+    { 6536,  5,  0,  6},     // 0x00fd
+    { 6576,  5,  0,  6},     // 0x00fe
+    { 6616,  5,  0,  6},     // 0x00ff
+    { 6656,  4,  0,  5},     // 0x2013
+    { 6688,  6,  0,  7},     // 0x2014
+    { 6736,  2,  0,  3},     // 0x2018
+    { 6752,  2,  0,  3},     // 0x2019
+    { 6768,  4,  0,  5},     // 0x201c
+    { 6800,  4,  0,  5},     // 0x201d
+    { 6832,  3,  0,  4},     // 0x2022
+    { 6856,  5,  0,  6},     // 0x2026
+    { 6896,  5,  0,  6},     // 0x20ac
+    { 6936,  5,  0,  6},     // 0x2190
+    { 6976,  5,  0,  6},     // 0x2191
+    { 7016,  5,  0,  6},     // 0x2192
+    { 7056,  5,  0,  6},     // 0x2193
+    { 7096,  5,  0,  6},     // 0x2665
+    { 7136,  5,  0,  6},     // 0x266a
+};
+
+static const uint16_t neo_font_plain_codes[15] = {
+    0x2013, 0x2014, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2026,
+    0x20ac, 0x2190, 0x2191, 0x2192, 0x2193, 0x2665, 0x266a,
+};
+
+extern const NeoFont neo_font_plain;
+const NeoFont neo_font_plain = {neo_font_plain_bitmap, neo_font_plain_glyphs, neo_font_plain_codes, 15, NULL, 0, 0x0020, 0x00ff, 0x003f, 8};
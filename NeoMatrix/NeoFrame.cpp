@@ -0,0 +1,50 @@
+/**********************************************
+ * NeoFrame.cpp
+ *
+ *  Frame pacing. Times are compared by their difference, so the schedule keeps
+ *  working when the microsecond clock wraps every 71 minutes.
+ */
+
+#include "NeoFrame.h"
+
+
+NeoFrameTimer::NeoFrameTimer(int fps)
+{
+    setRate(fps);
+    next = 0;
+    started = false;
+    count = 0;
+    skipped = 0;
+}
+
+void NeoFrameTimer::setRate(int fps)
+{
+    if (fps < 1)
+        fps = 1;
+    period = 1000000 / fps;
+    if (period < 1)
+        period = 1;         // due() divides by the period
+}
+
+bool NeoFrameTimer::due(uint32_t us)
+{
+    if (!started)
+    {
+        next = us;
+        started = true;
+    }
+    if ((int32_t)(us - next) < 0)
+        return false;
+
+    // note: the schedule moves on from when the frame was due rather than from now, so the rate does not drift
+    next += period;
+    if ((int32_t)(us - next) >= 0)
+    {
+        // more than a frame behind; skip to the frame in progress
+        uint32_t behind = (us - next) / period + 1;
+        skipped += behind;
+        next += behind * period;
+    }
+    count++;
+    return true;
+}
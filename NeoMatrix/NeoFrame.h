@@ -0,0 +1,75 @@
+/**
+ * NeoFrame.h
+ *
+ * Paces a drawing loop to a fixed frame rate. The timer takes the time from the
+ * caller rather than waiting, so the loop keeps running (sampling audio, say)
+ * between frames and draws only when a frame is due, e.g.
+ *
+ *     NeoFrameTimer frames(60);
+ *     Timer t;
+ *     t.start();
+ *     while (true)
+ *     {
+ *         if (frames.due(t.read_us()))
+ *         {
+ *             ticker.update(t.read_ms());
+ *             array.write();
+ *         }
+ *     }
+ *
+ */
+
+#ifndef NEOFRAME_H
+#define NEOFRAME_H
+
+#include "NeoSink.h"
+
+/**
+ * A schedule of frames at a fixed rate
+ */
+class NeoFrameTimer
+{
+    public:
+        /**
+         * Create a NeoFrameTimer. The first call to due() starts the schedule.
+         *
+         * @param fps Frames per second
+         */
+        NeoFrameTimer(int fps);
+
+        /**
+         * Sets the frame rate from the next frame on
+         *
+         * @param fps Frames per second, from 1 up to 1000000
+         */
+        void setRate(int fps);
+
+        /**
+         * Returns true once for each frame when its time has come. Frames are due
+         * on a fixed schedule, so a frame drawn late does not delay the next one;
+         * frames that are already over when due() is called are skipped.
+         *
+         * @param us The time in microseconds, from any free running clock
+         * @returns true if a frame should be drawn now
+         */
+        bool due(uint32_t us);
+
+        /**
+         * Returns the number of frames skipped because the loop was too slow
+         */
+        uint32_t missed() const { return skipped; }
+
+        /**
+         * Returns the number of frames due so far
+         */
+        uint32_t frames() const { return count; }
+
+    protected:
+        uint32_t period;            // microseconds per frame
+        uint32_t next;              // time the next frame is due
+        bool started;
+        uint32_t count;
+        uint32_t skipped;
+};
+
+#endif
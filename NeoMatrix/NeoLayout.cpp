@@ -0,0 +1,71 @@
+/**********************************************
+ * NeoLayout.cpp
+ *
+ *  Canvas to chain mapping for grids of NeoMatrix boards. Inside a board the
+ *  chain runs up each column, so a board pixel (x, y) is number x*8 + y.
+ */
+
+#include "NeoLayout.h"
+
+
+NeoLayout::NeoLayout(int tilesX, int tilesY, bool serpentine) :
+    tilesX(tilesX), tilesY(tilesY), serpentine(serpentine)
+{
+    if (this->tilesX < 1)
+        this->tilesX = 1;
+    if (this->tilesX > NEO_MAX_TILES)
+        this->tilesX = NEO_MAX_TILES;
+    if (this->tilesY < 1)
+        this->tilesY = 1;
+    if (this->tilesX * this->tilesY > NEO_MAX_TILES)
+        this->tilesY = NEO_MAX_TILES / this->tilesX;
+    setAll(NEO_ROTATE_0);
+}
+
+void NeoLayout::setTile(int tx, int ty, int orientation)
+{
+    if (tx >= 0 && tx < tilesX && ty >= 0 && ty < tilesY)
+        orient[ty * tilesX + tx] = orientation;
+}
+
+void NeoLayout::setAll(int orientation)
+{
+    for (int i = 0; i < NEO_MAX_TILES; i++)
+        orient[i] = orientation;
+}
+
+int NeoLayout::index(int x, int y) const
+{
+    int tx = x / 8;
+    int ty = y / 8;
+    int u = x % 8;      // position inside the board as seen on the canvas
+    int v = y % 8;
+
+    int o = orient[ty * tilesX + tx];
+    if (o & NEO_FLIP_X)
+        u = 7 - u;
+    if (o & NEO_FLIP_Y)
+        v = 7 - v;
+
+    int bx, by;         // position in the board's own co-ordinates
+    switch (o & 3)
+    {
+        case NEO_ROTATE_90:  bx = 7 - v; by = u;     break;
+        case NEO_ROTATE_180: bx = 7 - u; by = 7 - v; break;
+        case NEO_ROTATE_270: bx = v;     by = 7 - u; break;
+        default:             bx = u;     by = v;     break;
+    }
+
+    // chain position of the board
+    int link = (serpentine && (ty & 1)) ? ty * tilesX + (tilesX - 1 - tx) : ty * tilesX + tx;
+    return link * 64 + bx * 8 + by;
+}
+
+void NeoLayout::build(uint16_t *map) const
+{
+    int w = width();
+    int h = height();
+    for (int x = 0; x < w; x++)
+        for (int y = 0; y < h; y++)
+            map[x * h + y] = index(x, y);
+}
@@ -0,0 +1,83 @@
+/**
+ * NeoLayout.h
+ *
+ * Describes how a grid of 8x8 boards is chained and mounted. NeoArr expands a
+ * layout into a table holding the chain index of every canvas pixel, so drawing
+ * looks the position up instead of working it out for each pixel.
+ *
+ */
+
+#ifndef NEOLAYOUT_H
+#define NEOLAYOUT_H
+
+#include "NeoSink.h"
+
+// board orientations for NeoLayout::setTile(); a rotation may be combined with the flips
+#define NEO_ROTATE_0    0   // board x and y run along the canvas x and y
+#define NEO_ROTATE_90   1   // board turned a quarter turn clockwise
+#define NEO_ROTATE_180  2   // board upside down
+#define NEO_ROTATE_270  3   // board turned a quarter turn counter clockwise
+#define NEO_FLIP_X      4   // board mirrored left to right
+#define NEO_FLIP_Y      8   // board mirrored top to bottom
+
+#define NEO_MAX_TILES   64  // the most boards a layout can describe
+
+/**
+ * A canvas of tilesX by tilesY boards. The chain starts at the bottom left
+ * board and runs along each row of boards from left to right, or back and
+ * forth when serpentine chaining is used.
+ */
+class NeoLayout
+{
+    public:
+        /**
+         * Create a NeoLayout with every board in the NEO_ROTATE_0 orientation
+         *
+         * @param tilesX The number of boards across
+         * @param tilesY The number of boards up
+         * @param serpentine true if every second row of boards is chained right to left
+         */
+        NeoLayout(int tilesX, int tilesY = 1, bool serpentine = false);
+
+        /**
+         * Sets how the board at a grid position is mounted
+         *
+         * @param tx The column of the board in the grid, 0 on the left
+         * @param ty The row of the board in the grid, 0 at the bottom
+         * @param orientation One of the NEO_ROTATE values, optionally or'ed with NEO_FLIP_X and NEO_FLIP_Y
+         */
+        void setTile(int tx, int ty, int orientation);
+
+        /**
+         * Sets the orientation of every board
+         */
+        void setAll(int orientation);
+
+        /**
+         * Returns the chain index of a canvas pixel
+         *
+         * @param x The canvas x co-ordinate, 0 to width()-1
+         * @param y The canvas y co-ordinate, 0 to height()-1
+         */
+        int index(int x, int y) const;
+
+        /**
+         * Fills map with the chain index of every canvas pixel, column by column
+         * (map[x*height() + y])
+         */
+        void build(uint16_t *map) const;
+
+        int width() const { return tilesX * 8; }
+        int height() const { return tilesY * 8; }
+        int columns() const { return tilesX; }
+        int rows() const { return tilesY; }
+        int tiles() const { return tilesX * tilesY; }
+
+    protected:
+        int tilesX;                     // boards across
+        int tilesY;                     // boards up
+        bool serpentine;                // odd rows chained right to left
+        uint8_t orient[NEO_MAX_TILES];  // orientation of each board, row by row
+};
+
+#endif
@@ -0,0 +1,293 @@
+/**********************************************
+ * NeoList.cpp
+ *
+ *  Records NeoArr drawing calls. Each command is stored as five bytes, the
+ *  operation, the board and the red, green and blue of its color, followed by
+ *  its arguments as 16 bit values. Co-ordinate pairs come first among the
+ *  arguments so replay() can move them all the same way.
+ */
+
+#include "NeoList.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum
+{
+    OP_PIXEL, OP_LINE, OP_RECT, OP_FILLED_RECT, OP_SCREEN, OP_TRIANGLE,
+    OP_FILLED_TRIANGLE, OP_CIRCLE, OP_FILLED_CIRCLE, OP_CHAR, OP_CLEAR
+};
+
+static const uint8_t argCount[] = { 2, 4, 4, 4, 0, 6, 6, 3, 3, 3, 0 };     // 16 bit arguments of each operation
+static const uint8_t pointCount[] = { 1, 2, 2, 2, 0, 3, 3, 1, 1, 1, 0 };   // leading x, y pairs among them
+
+#define HEADER  5       // bytes before the arguments of a command
+
+
+NeoList::NeoList(int N) : cmds(NULL), used(0), size(0), N(N), cached(false), changed(true), canvas(false), cache(NULL), key(0), columns(0), rows(0)
+{
+}
+
+NeoList::~NeoList()
+{
+    free(cmds);
+    delete cache;
+}
+
+void NeoList::reset()
+{
+    used = 0;
+    changed = true;
+    canvas = false;
+}
+
+void NeoList::setCached(bool on)
+{
+    cached = on;
+    if (on && cache == NULL)
+    {
+        cache = new NeoArr(&cacheSink, N);
+        columns = rows = 0;     // the new cache has the default layout
+        changed = true;
+    }
+    else if (!on)
+    {
+        delete cache;       // the cache is as large as the back buffer of an array
+        cache = NULL;
+    }
+}
+
+void NeoList::record(int op, int idx, int color, int n, const int *args)
+{
+    int len = HEADER + 2*n;
+    if (used + len > size)
+    {
+        int grow = (size < 64) ? 64 : size * 2;
+        while (grow < used + len)
+            grow *= 2;
+        uint8_t *more = (uint8_t*)realloc(cmds, grow);
+        if (more == NULL)
+        {
+            printf("NeoList: ERROR unable to malloc command buffer");
+            return;
+        }
+        cmds = more;
+        size = grow;
+    }
+
+    uint8_t *c = &cmds[used];
+    c[0] = op;
+    c[1] = idx;
+    c[2] = (color & 0xFF0000) >> 16;
+    c[3] = (color & 0x00FF00) >> 8;
+    c[4] = (color & 0x0000FF);
+    for (int k = 0; k < n; k++)
+    {
+        c[HEADER + 2*k] = args[k] & 0xFF;
+        c[HEADER + 2*k + 1] = (args[k] >> 8) & 0xFF;
+    }
+    used += len;
+    changed = true;
+    if (idx == NEO_CANVAS)
+        canvas = true;
+}
+
+void NeoList::draw(NeoArr &array, int dx, int dy)
+{
+    int a[6];
+    for (int at = 0; at < used; at += HEADER + 2*argCount[cmds[at]])
+    {
+        const uint8_t *c = &cmds[at];
+        int op = c[0];
+        int idx = (int8_t)c[1];        // NEO_CANVAS is stored as -1
+        uint8_t red = c[2], green = c[3], blue = c[4];
+        for (int k = 0; k < argCount[op]; k++)
+            a[k] = (int16_t)(c[HEADER + 2*k] | (c[HEADER + 2*k + 1] << 8));
+        for (int k = 0; k < pointCount[op]; k++)
+        {
+            a[2*k] += dx;
+            a[2*k + 1] += dy;
+        }
+
+        switch (op)
+        {
+            case OP_PIXEL:              array.setPixel(idx, a[0], a[1], red, green, blue); break;
+            case OP_LINE:               array.drawLine(idx, a[0], a[1], a[2], a[3], red, green, blue); break;
+            case OP_RECT:               array.drawRect(idx, a[0], a[1], a[2], a[3], red, green, blue); break;
+            case OP_FILLED_RECT:        array.drawFilledRect(idx, a[0], a[1], a[2], a[3], red, green, blue); break;
+            case OP_SCREEN:             array.fillScreen(idx, red, green, blue); break;
+            case OP_TRIANGLE:           array.drawTriangle(idx, a[0], a[1], a[2], a[3], a[4], a[5], red, green, blue); break;
+            case OP_FILLED_TRIANGLE:    array.drawFilledTriangle(idx, a[0], a[1], a[2], a[3], a[4], a[5], red, green, blue); break;
+            case OP_CIRCLE:             array.drawCircle(idx, a[0], a[1], a[2], red, green, blue); break;
+            case OP_FILLED_CIRCLE:      array.drawFilledCircle(idx, a[0], a[1], a[2], red, green, blue); break;
+            case OP_CHAR:               array.drawChar(idx, a[0], a[1], (char)a[2], red, green, blue); break;
+            default:                    array.clear(); break;
+        }
+    }
+}
+
+// draws the list into the cache, on a color that no command draws, with the grid of array
+void NeoList::rasterize(const NeoArr &array)
+{
+    if (array.columns() != columns || array.rows() != rows)
+    {
+        // note: unrotated boards chained row by row keep each row of boards as columns from the bottom up, as a sprite stores them
+        columns = array.columns();
+        rows = array.rows();
+        cache->setLayout(NeoLayout(columns, rows));
+    }
+
+    for (key = 1; ; key++)
+    {
+        int at = 0;
+        while (at < used && ((cmds[at+2] << 16) | (cmds[at+3] << 8) | cmds[at+4]) != key)
+            at += HEADER + 2*argCount[cmds[at]];
+        if (at >= used)
+            break;
+    }
+
+    for (int b = 0; b < N; b++)
+        cache->fillScreen(b, key);
+    draw(*cache, 0, 0);
+    changed = false;
+}
+
+void NeoList::replay(NeoArr &array, int dx, int dy)
+{
+    if (!cached || cache == NULL)
+    {
+        draw(array, dx, dy);
+        return;
+    }
+
+    if (changed || array.columns() != columns || array.rows() != rows)
+        rasterize(array);
+    if (canvas)
+    {
+        for (int r = 0; r < rows; r++)
+        {
+            NeoSprite row = {cache->column(r*columns, 0), NULL, (uint16_t)(columns*8), 8, NEO_SPRITE_RGB888, NEO_SPRITE_KEY, (uint32_t)key};
+            array.blit(NEO_CANVAS, dx, dy + r*8, row);
+        }
+        return;
+    }
+    for (int b = 0; b < columns*rows; b++)
+    {
+        NeoSprite board = {cache->column(b, 0), NULL, 8, 8, NEO_SPRITE_RGB888, NEO_SPRITE_KEY, (uint32_t)key};
+        array.blit(b, dx, dy, board);
+    }
+}
+
+void NeoList::setPixel(int idx, int x, int y, int color)
+{
+    int a[] = {x, y};
+    record(OP_PIXEL, idx, color, 2, a);
+}
+
+void NeoList::setPixel(int idx, int x, int y, uint8_t red, uint8_t green, uint8_t blue)
+{
+    setPixel(idx, x, y, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::drawLine(int idx, int x1, int y1, int x2, int y2, int color)
+{
+    int a[] = {x1, y1, x2, y2};
+    record(OP_LINE, idx, color, 4, a);
+}
+
+void NeoList::drawLine(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue)
+{
+    drawLine(idx, x1, y1, x2, y2, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::drawRect(int idx, int x1, int y1, int x2, int y2, int color)
+{
+    int a[] = {x1, y1, x2, y2};
+    record(OP_RECT, idx, color, 4, a);
+}
+
+void NeoList::drawRect(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue)
+{
+    drawRect(idx, x1, y1, x2, y2, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::drawFilledRect(int idx, int x1, int y1, int x2, int y2, int color)
+{
+    int a[] = {x1, y1, x2, y2};
+    record(OP_FILLED_RECT, idx, color, 4, a);
+}
+
+void NeoList::drawFilledRect(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue)
+{
+    drawFilledRect(idx, x1, y1, x2, y2, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::fillScreen(int idx, int color)
+{
+    record(OP_SCREEN, idx, color, 0, NULL);
+}
+
+void NeoList::fillScreen(int idx, uint8_t red, uint8_t green, uint8_t blue)
+{
+    fillScreen(idx, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::drawTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, int color)
+{
+    int a[] = {x1, y1, x2, y2, x3, y3};
+    record(OP_TRIANGLE, idx, color, 6, a);
+}
+
+void NeoList::drawTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, uint8_t red, uint8_t green, uint8_t blue)
+{
+    drawTriangle(idx, x1, y1, x2, y2, x3, y3, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::drawFilledTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, int color)
+{
+    int a[] = {x1, y1, x2, y2, x3, y3};
+    record(OP_FILLED_TRIANGLE, idx, color, 6, a);
+}
+
+void NeoList::drawFilledTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, uint8_t red, uint8_t green, uint8_t blue)
+{
+    drawFilledTriangle(idx, x1, y1, x2, y2, x3, y3, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::drawCircle(int idx, int x, int y, int r, int color)
+{
+    int a[] = {x, y, r};
+    record(OP_CIRCLE, idx, color, 3, a);
+}
+
+void NeoList::drawCircle(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue)
+{
+    drawCircle(idx, x, y, r, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::drawFilledCircle(int idx, int x, int y, int r, int color)
+{
+    int a[] = {x, y, r};
+    record(OP_FILLED_CIRCLE, idx, color, 3, a);
+}
+
+void NeoList::drawFilledCircle(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue)
+{
+    drawFilledCircle(idx, x, y, r, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::drawChar(int idx, int x, int y, char c, int color)
+{
+    int a[] = {x, y, c};
+    record(OP_CHAR, idx, color, 3, a);
+}
+
+void NeoList::drawChar(int idx, int x, int y, char c, uint8_t red, uint8_t green, uint8_t blue)
+{
+    drawChar(idx, x, y, c, (red << 16) | (green << 8) | blue);
+}
+
+void NeoList::clear()
+{
+    record(OP_CLEAR, 0, 0, 0, NULL);
+}
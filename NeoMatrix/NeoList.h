@@ -0,0 +1,104 @@
+/**
+ * NeoList.h
+ *
+ * Display lists for NeoArr. A NeoList records drawing calls into a compact
+ * command buffer and replays them onto an array, optionally moved by an offset.
+ * A cached list is drawn once into a bitmap of its own and each replay blits
+ * that bitmap instead of drawing again, until the list is changed.
+ *
+ * The commands take the same arguments as the NeoArr functions of the same name.
+ *
+ */
+
+#ifndef NEOLIST_H
+#define NEOLIST_H
+
+#include "NeoMatrix.h"
+
+/**
+ * A recorded sequence of NeoArr drawing calls
+ */
+class NeoList
+{
+    public:
+        /**
+         * Create an empty NeoList
+         *
+         * @param N The number of 8x8 boards of the arrays the list is replayed on
+         */
+        NeoList(int N);
+        ~NeoList();
+
+        /**
+         * Removes every command
+         */
+        void reset();
+
+        /**
+         * Turns the cached bitmap on or off. A cached list only keeps what it draws
+         * on the boards with no offset, and replay() moves that picture; the pixels
+         * it never drew are left as they are. Each board is moved on its own unless
+         * the list draws on NEO_CANVAS; then it is moved across the whole canvas. The
+         * cache has the same grid of boards as the array it is replayed on, and is
+         * drawn again when the list is replayed on an array with another grid.
+         *
+         * @param on true to draw the list once and blit it on every replay
+         */
+        void setCached(bool on);
+
+        /**
+         * Draws the list onto an array
+         *
+         * @param array The array to draw on
+         * @param dx Added to every x co-ordinate
+         * @param dy Added to every y co-ordinate
+         */
+        void replay(NeoArr &array, int dx = 0, int dy = 0);
+
+        /**
+         * Returns the number of bytes of recorded commands
+         */
+        int length() const { return used; }
+
+        void setPixel(int idx, int x, int y, int color);
+        void setPixel(int idx, int x, int y, uint8_t red, uint8_t green, uint8_t blue);
+        void drawLine(int idx, int x1, int y1, int x2, int y2, int color);
+        void drawLine(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue);
+        void drawRect(int idx, int x1, int y1, int x2, int y2, int color);
+        void drawRect(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue);
+        void drawFilledRect(int idx, int x1, int y1, int x2, int y2, int color);
+        void drawFilledRect(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue);
+        void fillScreen(int idx, int color);
+        void fillScreen(int idx, uint8_t red, uint8_t green, uint8_t blue);
+        void drawTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, int color);
+        void drawTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, uint8_t red, uint8_t green, uint8_t blue);
+        void drawFilledTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, int color);
+        void drawFilledTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, uint8_t red, uint8_t green, uint8_t blue);
+        void drawCircle(int idx, int x, int y, int r, int color);
+        void drawCircle(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue);
+        void drawFilledCircle(int idx, int x, int y, int r, int color);
+        void drawFilledCircle(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue);
+        void drawChar(int idx, int x, int y, char c, int color);
+        void drawChar(int idx, int x, int y, char c, uint8_t red, uint8_t green, uint8_t blue);
+        void clear();
+
+    protected:
+        uint8_t *cmds;          // recorded commands, see NeoList.cpp
+        int used;               // bytes of cmds in use
+        int size;               // bytes allocated for cmds
+        int N;                  // boards of the arrays the list is replayed on
+        bool cached;            // replay() blits the cache
+        bool changed;           // the cache no longer matches the commands
+        bool canvas;            // a command draws on NEO_CANVAS
+        NeoNullSink cacheSink;
+        NeoArr *cache;          // the list drawn with no offset, key colored where nothing was drawn
+        int key;                // a color the list never draws
+        int columns;            // boards across the canvas of the cache
+        int rows;               // boards up the canvas of the cache
+
+        void record(int op, int idx, int color, int n, const int *args);
+        void draw(NeoArr &array, int dx, int dy);
+        void rasterize(const NeoArr &array);
+};
+
+#endif
@@ -0,0 +1,250 @@
+/**********************************************
+ * NeoMarquee.cpp
+ *
+ *  Scrolling text for NeoArr. A message is rendered into a strip of one byte
+ *  columns with a blank window width on either side, so it scrolls in from
+ *  blank and out to blank and the window is always one blit from the strip.
+ *  A smooth frame between two columns is one blit of an indexed copy of the
+ *  window, each pixel picking one of four colors by whether it is set in the
+ *  strip column to its left and the one to its right.
+ */
+
+#include "NeoMarquee.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLYPH_WIDTH 6       // columns of a font.h glyph
+
+
+// mixes two 24 bit colors, weight 0 keeps from and 256 gives to
+static int mix(int from, int to, int weight)
+{
+    int color = 0;
+    for (int shift = 0; shift < 24; shift += 8)
+    {
+        int a = (from >> shift) & 0xFF;
+        int b = (to >> shift) & 0xFF;
+        color |= ((a * (256 - weight) + b * weight) >> 8) << shift;
+    }
+    return color;
+}
+
+// turns a font.h column (bit 0 at the top) into a strip column (bit 0 at the bottom)
+static uint8_t flip(uint8_t v)
+{
+    v = (v >> 4) | (v << 4);
+    v = ((v >> 2) & 0x33) | ((v << 2) & 0xCC);
+    return ((v >> 1) & 0x55) | ((v << 1) & 0xAA);
+}
+
+
+NeoMarquee::NeoMarquee(NeoArr *out, int x, int y, int w) : out(out), x(x), y(y), w(w)
+{
+    head = 0;
+    count = 0;
+    speed = 20;
+    background = 0;
+    font = NULL;
+    repeat = false;
+    started = false;
+    start = 0;
+    shown = -1;
+    blend = NULL;
+}
+
+NeoMarquee::~NeoMarquee()
+{
+    reset();
+    free(blend);
+}
+
+bool NeoMarquee::show(const char *text, int color)
+{
+    if (count == NEO_MARQUEE_QUEUE)
+        return false;
+
+    int width = 2*w + (font ? neo_text_width(*font, text) : strlen(text) * GLYPH_WIDTH);
+    uint8_t *columns = (width <= 0xFFFF) ? (uint8_t*)malloc(width) : NULL;
+    if (columns == NULL)
+    {
+        printf("NeoMarquee: ERROR unable to malloc message strip");
+        return false;
+    }
+
+    memset(columns, 0, width);
+    if (font)
+    {
+        // note: glyphs are ORed in, as kerning can overlap them
+        int pen = w;
+        uint32_t c = neo_utf8_next(text);
+        while (c)
+        {
+            uint32_t next = neo_utf8_next(text);
+            const NeoGlyph &g = neo_font_glyph(*font, c);
+            for (int j = 0; j < g.width; j++)
+            {
+                int col = pen + g.left + j;
+                if (col >= 0 && col < width)
+                    columns[col] |= neo_font_column(*font, g, j);
+            }
+            pen += g.advance;
+            if (next)
+                pen += neo_font_kern(*font, c, next);
+            c = next;
+        }
+    }
+    else
+    {
+        uint8_t *c = columns + w;
+        for (; *text; text++)
+        {
+            const uint8_t *glyph = neo_glyph(*text);
+            for (int j = 0; j < GLYPH_WIDTH; j++)
+                *c++ = flip(glyph[j]);
+        }
+    }
+
+    Message &m = queue[(head + count) % NEO_MARQUEE_QUEUE];
+    m.columns = columns;
+    m.width = width;
+    m.palette[0] = background;
+    m.palette[1] = color;
+    if (count++ == 0)
+    {
+        started = false;        // starts on the next update()
+        shown = -1;
+    }
+    return true;
+}
+
+void NeoMarquee::reset()
+{
+    while (count > 0)
+        next();
+    shown = -1;
+}
+
+void NeoMarquee::setSpeed(int pps)
+{
+    if (pps < 0)
+        pps = 0;
+    speed = pps;
+}
+
+void NeoMarquee::setBackground(int color)
+{
+    background = color;
+    for (int i = 0; i < count; i++)
+        queue[(head + i) % NEO_MARQUEE_QUEUE].palette[0] = color;
+    shown = -1;
+}
+
+void NeoMarquee::setFont(const NeoFont *font)
+{
+    if (font && font->height > 8)
+    {
+        printf("NeoMarquee: ERROR font is taller than the window");
+        return;
+    }
+    this->font = font;
+}
+
+bool NeoMarquee::setSmooth(bool on)
+{
+    if (on && blend == NULL)
+    {
+        blend = (uint8_t*)malloc(w * 8);
+        if (blend == NULL)
+        {
+            printf("NeoMarquee: ERROR unable to malloc blend buffer");
+            return false;
+        }
+    }
+    else if (!on)
+    {
+        free(blend);
+        blend = NULL;
+    }
+    shown = -1;
+    return true;
+}
+
+void NeoMarquee::setRepeat(bool on)
+{
+    repeat = on;
+}
+
+// drops the message showing
+void NeoMarquee::next()
+{
+    free(queue[head].columns);
+    head = (head + 1) % NEO_MARQUEE_QUEUE;
+    count--;
+    started = false;
+}
+
+bool NeoMarquee::update(uint32_t ms)
+{
+    if (count > 0 && !started)
+    {
+        start = ms;
+        started = true;
+    }
+
+    // note: the position comes from the time since the message started, so late updates skip pixels rather than slow down
+    uint32_t pos = (count > 0) ? (uint32_t)((uint64_t)(ms - start) * speed * 256 / 1000) : 0;
+    int offset = pos >> 8;
+    if (count > 0 && offset > queue[head].width - w)
+    {
+        // scrolled out; the strip ends blank, so the next message (or this one again) starts blank
+        if (count > 1 || !repeat)
+            next();
+        start = ms;
+        started = true;
+        pos = 0;
+        offset = 0;
+        shown = -1;
+    }
+
+    if (count == 0)
+    {
+        if (shown == -1)
+        {
+            out->drawFilledRect(NEO_CANVAS, x, y, x + w - 1, y + 7, background);
+            shown = 0;
+            return true;
+        }
+        return false;
+    }
+
+    int frac = blend ? (pos & 0xFF) : 0;
+    if (offset == queue[head].width - w)
+        frac = 0;               // the last position, nothing to its right
+    int at = (offset << 8) | frac;
+    if (at == shown)
+        return false;
+    const Message &m = queue[head];
+    if (frac == 0)
+    {
+        NeoSprite strip = {m.columns, m.palette, (uint16_t)m.width, 8, NEO_SPRITE_MONO, 0, 0};
+        out->blit(NEO_CANVAS, x, y, strip, offset, 0, w, 8);
+    }
+    else
+    {
+        // each pixel moves frac/256 of the way from the column on its left to the one on its right
+        mixed[0] = m.palette[0];
+        mixed[1] = mix(m.palette[0], m.palette[1], 256 - frac);
+        mixed[2] = mix(m.palette[0], m.palette[1], frac);
+        mixed[3] = m.palette[1];
+        const uint8_t *c = m.columns + offset;
+        uint8_t *p = blend;
+        for (int i = 0; i < w; i++, c++)
+            for (int r = 0; r < 8; r++)
+                *p++ = ((c[0] >> r) & 1) | (((c[1] >> r) & 1) << 1);
+        NeoSprite window = {blend, mixed, (uint16_t)w, 8, NEO_SPRITE_INDEXED, 0, 0};
+        out->blit(NEO_CANVAS, x, y, window);
+    }
+    shown = at;
+    return true;
+}
@@ -0,0 +1,153 @@
+/**
+ * NeoMarquee.h
+ *
+ * Scrolls text through a strip of the canvas. Each message is drawn once with
+ * the font.h glyphs (or a NeoFont given to setFont()) into a one bit per pixel
+ * strip, and every frame is a single blit of the part of the strip in view, so
+ * the cost of a frame does not depend on the length of the message.
+ *
+ * A window as wide as the canvas, e.g. NeoMarquee(&array, 0, 0, boards * 8) on
+ * boards side by side, runs the text across the whole chain as one ticker.
+ * With setSmooth() the text moves in steps of 1/256 of a pixel, each column
+ * blended from the two strip columns it lies between, so a slow scroll drawn
+ * at 60 frames per second (see NeoFrameTimer) glides rather than jumps.
+ *
+ * update() takes the time rather than waiting, so several marquees (and other
+ * drawing) share one loop and one write(), e.g.
+ *
+ *     NeoMarquee top(&array, 0, 8, 32), bottom(&array, 0, 0, 32);
+ *     top.show("ZACH", 0xFFFFFF);
+ *     bottom.show("THANKS", 0x80FF80);
+ *     Timer t;
+ *     t.start();
+ *     while (true)
+ *     {
+ *         top.update(t.read_ms());
+ *         bottom.update(t.read_ms());
+ *         array.write();
+ *     }
+ *
+ */
+
+#ifndef NEOMARQUEE_H
+#define NEOMARQUEE_H
+
+#include "NeoMatrix.h"
+
+#define NEO_MARQUEE_QUEUE   4       // messages a marquee can hold, including the one showing
+
+/**
+ * A window of the canvas that text scrolls through from right to left
+ */
+class NeoMarquee
+{
+    public:
+        /**
+         * Create a NeoMarquee. The window is 8 pixels high and given in canvas
+         * co-ordinates, as drawn with NEO_CANVAS.
+         *
+         * @param out The array to draw on
+         * @param x The canvas x co-ordinate of the left of the window
+         * @param y The canvas y co-ordinate of the bottom of the window
+         * @param w The width of the window in pixels
+         */
+        NeoMarquee(NeoArr *out, int x, int y, int w);
+        ~NeoMarquee();
+
+        /**
+         * Adds a message to the queue. It scrolls in from the right once the
+         * messages before it have scrolled out on the left.
+         *
+         * @param text The message, in UTF-8 when a NeoFont is set; it is drawn straight away and not kept
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         * @returns false if the queue is full or the strip could not be allocated
+         */
+        bool show(const char *text, int color);
+
+        /**
+         * Removes every message and blanks the window on the next update()
+         */
+        void reset();
+
+        /**
+         * Sets the scrolling speed; the default is 20 pixels per second
+         *
+         * @param pps Pixels per second
+         */
+        void setSpeed(int pps);
+
+        /**
+         * Sets the color behind the text; the default is black
+         *
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void setBackground(int color);
+
+        /**
+         * Sets the font of the messages shown after this call
+         *
+         * @param font A NeoFont at most 8 rows high, or NULL for the 6x8 font.h glyphs
+         */
+        void setFont(const NeoFont *font);
+
+        /**
+         * Sets whether the text moves by fractions of a pixel, blending each
+         * column between the two it lies between; the default is whole pixels
+         *
+         * @param on true for sub-pixel steps
+         * @returns false if the blend buffer could not be allocated
+         */
+        bool setSmooth(bool on);
+
+        /**
+         * Sets whether the last message starts again when the queue runs out
+         *
+         * @param on true to repeat the last message
+         */
+        void setRepeat(bool on);
+
+        /**
+         * Draws the window for the given time. Nothing is drawn when the text has
+         * not moved since the last call, by a whole pixel or by 1/256 of one
+         * with setSmooth().
+         *
+         * @param ms The time in milliseconds, from any free running clock
+         * @returns true if the window was drawn
+         */
+        bool update(uint32_t ms);
+
+        /**
+         * Returns true when no message is queued or showing
+         */
+        bool idle() const { return count == 0; }
+
+    protected:
+        /**
+         * One rendered message
+         */
+        typedef struct _Message
+        {
+            uint8_t *columns;       // one byte per column, bit 0 at the bottom, a window of blank columns at each end
+            int width;              // columns in the strip
+            int palette[2];         // background and text color
+        } Message;
+
+        NeoArr *out;
+        int x, y, w;                // window on the canvas
+        Message queue[NEO_MARQUEE_QUEUE];
+        int head;                   // message showing
+        int count;                  // messages queued, including the one showing
+        int speed;                  // pixels per second
+        int background;
+        const NeoFont *font;        // NULL for font.h
+        bool repeat;
+        bool started;               // start holds the time the message showing began
+        uint32_t start;
+        int shown;                  // position drawn last, in 1/256 pixels from the start of the strip, -1 to draw on the next update()
+        uint8_t *blend;             // w columns of 8 palette indices for a smooth frame, NULL when not smooth
+        int mixed[4];               // palette of a smooth frame: background, left column only, right column only, text
+
+        void next();
+};
+
+#endif
@@ -8,22 +8,23 @@
  *  Because of the global nature of the IO register and bitmask variables, only one contiguous chain of NeoMatrix Arrays can be connected
  *  A large number of NeoMatrix arrays can be chained together by tying Din to Dout of sucessive arrays, but an external power sourece may be required
  *
- *  This library supports only the NXP LPC1768
+ *  The strip itself can only be driven from the NXP LPC1768; on other targets the
+ *  pixel data is handed to one of the host sinks in NeoSink.h
  */
 
+#ifdef TARGET_LPC1768
 #include "mbed.h"
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#endif
 #include "NeoMatrix.h"
+#include "NeoProfile.h"
 #include "font.h"
 
 
-// FastIO register address and bitmask for the GPIO pin
-// because these are imported in the assembly
-uint32_t neo_fio_reg;
-uint32_t neo_bitmask;
-
-// function to write to the strip, implemented in ARM assembly
-extern "C" void neo_out(NeoColor*, int);
-
  #define max(a,b) \
    ({ __typeof__ (a) _a = (a); \
        __typeof__ (b) _b = (b); \
@@ -36,25 +37,245 @@ extern "C" void neo_out(NeoColor*, int);
      
 
 
-NeoArr::NeoArr(PinName pin, int N) : N(N)
+#ifdef TARGET_LPC1768
+NeoArr::NeoArr(PinName pin, int N)
+{
+    sink = new NeoGpioSink(pin);
+    ownsSink = true;
+    init(N);
+}
+#endif
+
+NeoArr::NeoArr(NeoSink *sink, int N) : sink(sink), ownsSink(false)
+{
+    init(N);
+}
+
+NeoArr::~NeoArr()
+{
+    while (sink->busy());
+    free(arr);
+    free(index);
+    free(palette);
+    free(front);
+    free(map);
+    free(strip);
+    free(extents);
+    delete dither;
+    if (ownsSink)
+        delete sink;
+}
+
+void NeoArr::init(int N)
 {
+    this->N = N;
+    async = false;
+    dither = NULL;
+    index = NULL;
+    palette = NULL;
     bright = 0.5;
+    gamma = NEO_GAMMA;
     Nbytes = N * 64 * 3;
     arr = (NeoColor*)malloc(N * 64 * sizeof(NeoColor));
-    if (arr == NULL)
+    front = (NeoColor*)malloc(N * 64 * sizeof(NeoColor));
+    if (arr == NULL || front == NULL)
     {
         printf("NeoArr: ERROR unable to malloc pixel array data");
-        N = 0;
+        this->N = 0;
+        Nbytes = 0;
     }
-    
-    //gpio_init(&gpio, pin, PIN_OUTPUT);      // initialize GPIO registers
-    neo_fio_reg = (uint32_t)gpio.reg_dir;   // set registers and bitmask for
-    neo_bitmask = 1 << ((int)pin & 0x1F);   // the assembly to use
+    litMax = this->N*64 - 1;    // malloc leaves the buffer undefined
+    dirtyMax = -1;
+    clear();
+    invalidate();   // the strip contents are unknown until the first write
+    buildLut();
+
+    map = NULL;
+    strip = NULL;
+    extents = NULL;
+    width = height = tiles = 0;
+    clipW = clipH = 8;
+    tilesX = 1;
+    setLayout(NeoLayout(this->N, 1));
 }
 
 void NeoArr::setBrightness(float bright)
 {
+    if (bright == this->bright)
+        return;
     this->bright = bright;
+    buildLut();
+}
+
+void NeoArr::setGamma(float gamma)
+{
+    if (gamma == this->gamma)
+        return;
+    this->gamma = gamma;
+    buildLut();
+}
+
+void NeoArr::setLayout(const NeoLayout &layout)
+{
+    if (layout.tiles() > N)
+    {
+        printf("NeoArr: ERROR layout uses %d boards but only %d are chained", layout.tiles(), N);
+        return;
+    }
+
+    // rotate() wraps at most half the canvas the shorter way round, so its strip is set aside here
+    uint16_t *m = (uint16_t*)malloc(layout.width() * layout.height() * sizeof(uint16_t));
+    uint8_t *s = (uint8_t*)malloc(layout.width() * layout.height() / 2 * sizeof(NeoColor));
+    int *e = (int*)malloc(layout.width() * sizeof(int));
+    if (m == NULL || s == NULL || e == NULL)
+    {
+        printf("NeoArr: ERROR unable to malloc layout table");
+        free(m);
+        free(s);
+        free(e);
+        return;
+    }
+    layout.build(m);
+
+    free(map);
+    free(strip);
+    free(extents);
+    map = m;
+    strip = s;
+    extents = e;
+    width = layout.width();
+    height = layout.height();
+    tilesX = layout.columns();
+    tiles = layout.tiles();
+    linear = true;
+    for (int i = 0; i < width * height; i++)
+        if (map[i] != i)
+            linear = false;
+}
+
+void NeoArr::setIndexed(bool on)
+{
+    if (on == (index != NULL))
+        return;
+    while (sink->busy());
+
+    if (on)
+    {
+        uint8_t *ix = (uint8_t*)malloc(N * 64);
+        int *pal = (int*)malloc(256 * sizeof(int));
+        if (ix == NULL || pal == NULL)
+        {
+            printf("NeoArr: ERROR unable to malloc indexed pixel data");
+            free(ix);
+            free(pal);
+            return;
+        }
+        for (int i = 0; i < 256; i++)
+            pal[i] = i * 0x010101;
+        memset(ix, 0, N * 64);
+        free(arr);
+        arr = NULL;
+        index = ix;
+        palette = pal;
+    }
+    else
+    {
+        NeoColor *a = (NeoColor*)malloc(N * 64 * sizeof(NeoColor));
+        if (a == NULL)
+        {
+            printf("NeoArr: ERROR unable to malloc pixel array data");
+            return;
+        }
+        memset(a, 0, N * 64 * sizeof(NeoColor));
+        free(index);
+        free(palette);
+        index = NULL;
+        palette = NULL;
+        arr = a;
+    }
+
+    // the new buffer starts cleared and every pixel may come out different
+    litMax = -1;
+    dirtyMax = N*64 - 1;
+}
+
+void NeoArr::setPalette(const int *colors, int first, int n)
+{
+    if (palette == NULL)
+        return;
+    if (first < 0)
+    {
+        colors -= first;
+        n += first;
+        first = 0;
+    }
+    if (first + n > 256)
+        n = 256 - first;
+    if (n <= 0)
+        return;
+    memcpy(&palette[first], colors, n * sizeof(int));
+    dirtyMax = N*64 - 1;    // any pixel may use the entries
+}
+
+// reverses palette entries a to b
+static void reverse(int *p, int a, int b)
+{
+    for (; a < b; a++, b--)
+    {
+        int t = p[a];
+        p[a] = p[b];
+        p[b] = t;
+    }
+}
+
+void NeoArr::rotatePalette(int first, int last, int step)
+{
+    if (palette == NULL)
+        return;
+    first = max(first, 0);
+    last = min(last, 255);
+    int n = last - first + 1;
+    if (n < 2)
+        return;
+    step %= n;
+    if (step < 0)
+        step += n;
+    if (step == 0)
+        return;
+
+    // rotating right by step is three reversals, so no second palette is needed
+    reverse(palette, first, last);
+    reverse(palette, first, first + step - 1);
+    reverse(palette, first + step, last);
+    dirtyMax = N*64 - 1;
+}
+
+void NeoArr::setDither(int mode)
+{
+    while (sink->busy());
+    delete dither;
+    dither = NULL;
+    if (mode != NEO_DITHER_OFF)
+        dither = new NeoDither(N*64, mode);
+
+    // every lit pixel may come out different
+    if (litMax > dirtyMax)
+        dirtyMax = litMax;
+}
+
+void NeoArr::buildLut()
+{
+    float b = bright < 0 ? 0 : (bright > 1 ? 1 : bright);
+    for (int i = 0; i < 256; i++)
+    {
+        float v = 255.0f * b * pow(i / 255.0f, gamma);
+        lut[i] = (uint8_t)(v + 0.5f);
+        lut16[i] = (uint16_t)(v * 256.0f);
+    }
+
+    // every lit pixel changes on the strip
+    if (litMax > dirtyMax)
+        dirtyMax = litMax;
 }
 
 
@@ -69,11 +290,21 @@ void NeoArr::setPixel(int idx, int x, int y, int color)
 
 void NeoArr::setPixel(int idx, int x, int y, uint8_t red, uint8_t green, uint8_t blue)
 {
-    int pixel = idx*64 + x*8 + y;   // specify pixel based on board index, x, and y values
-    // modulate pixel by the total number of pixels
-    arr[pixel % (N*64)].red = (uint8_t)(red * bright);
-    arr[pixel % (N*64)].green = (uint8_t)(green * bright);
-    arr[pixel % (N*64)].blue = (uint8_t)(blue * bright);
+    // the board's corner on the canvas; the layout table gives the chain index
+    int ox, oy;
+    if (origin(idx, ox, oy))
+        plot(ox + x, oy + y, red, green, blue);
+}
+
+// integer division rounding down and up, for a positive divisor
+static int floorDiv(int a, int b)
+{
+    return (a >= 0) ? a / b : -((b - 1 - a) / b);
+}
+
+static int ceilDiv(int a, int b)
+{
+    return -floorDiv(-a, b);
 }
 
 void NeoArr::drawLine(int idx, int x1, int y1, int x2, int y2, int color)
@@ -87,18 +318,64 @@ void NeoArr::drawLine(int idx, int x1, int y1, int x2, int y2, int color)
 
 void NeoArr::drawLine(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue)
 {
-    float k;
-    int j = rint(sqrt(pow((x1-x2),2.0) + pow((y1-y2),2.0)));    // calculates magnitude of line
-    if(x1 != x2)  // handle infinite case
-        k = atan2( (float)(y2-y1),(float) ( x2-x1));    // calculates angle of line
+    // note: Bresenham walk along the longer axis; step i of the minor axis is at (2*i*db + da) / (2*da)
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return;
+
+    bool steep = abs(y2-y1) > abs(x2-x1);
+    int a = steep ? y1 : x1;                    // start on the major axis
+    int b = steep ? x1 : y1;                    // start on the minor axis
+    int da = steep ? abs(y2-y1) : abs(x2-x1);
+    int db = steep ? abs(x2-x1) : abs(y2-y1);
+    int sa = ((steep ? y2-y1 : x2-x1) < 0) ? -1 : 1;
+    int sb = ((steep ? x2-x1 : y2-y1) < 0) ? -1 : 1;
+
+    // clip the range of steps to the board once, first on the major axis...
+    int topA = (steep ? clipH : clipW) - 1;
+    int topB = (steep ? clipW : clipH) - 1;
+    int first = max(0, (sa > 0) ? -a : a-topA);
+    int last = min(da, (sa > 0) ? topA-a : a);
+
+    // ...then on the minor axis, which only moves forward as the steps go on
+    int lo = (sb > 0) ? -b : b-topB;
+    int hi = (sb > 0) ? topB-b : b;
+    if (db == 0)
+    {
+        if (lo > 0 || hi < 0)
+            return;
+    }
     else
-        k = acos(0.0);
-        
-    for(float n=0; n<=j; n++)   // set a number pixels equal to the magnitude of the line along the closest (rounded) line
-        if((x1+ rint(n*cos(k))) >=0 && (x1+rint( n*cos(k))) <=7 &&  (y1+rint(n*sin(k)))>=0 &&  (y1+rint(n*sin(k)))<=7)
-            setPixel(idx, x1+ rint(n*cos(k)), y1+ rint(n*sin(k)), red, green, blue);
-        
-    
+    {
+        first = max(first, ceilDiv(2*da*lo - da, 2*db));
+        last = min(last, floorDiv(2*da*(hi+1) - da - 1, 2*db));
+    }
+    if (first > last)
+        return;
+
+    if (da == 0)
+        da = 1;                                 // a single point; keeps the division below defined
+    int num = 2*first*db + da;
+    int m = num / (2*da);                       // minor axis offset at the first step
+    int err = num % (2*da);
+
+    int ca = a + sa*first;
+    int cb = b + sb*m;
+    const uint16_t *p = steep ? &map[(ox+cb)*height + oy+ca] : &map[(ox+ca)*height + oy+cb];
+    int stepA = steep ? sa : sa*height;         // map stride of one step on each axis
+    int stepB = steep ? sb*height : sb;
+
+    for (int i = first; i <= last; i++)
+    {
+        put(*p, red, green, blue);
+        p += stepA;
+        err += 2*db;
+        if (err >= 2*da)
+        {
+            err -= 2*da;
+            p += stepB;
+        }
+    }
 }
 
 void NeoArr::drawRect(int idx, int x1, int y1, int x2, int y2, int color)
@@ -112,26 +389,28 @@ void NeoArr::drawRect(int idx, int x1, int y1, int x2, int y2, int color)
 
 void NeoArr::drawRect(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue)
 {
-    // note: drawRect does not use drawLine function because the angles will always be 90 degrees and so for these for loops are faster
-    for(int i=0; i<=(abs(x2-x1)); i++){ // draws horizontal lines
-        if ((max(x1,x2)-i) >= 0 && max(x1, x2) -i <=7){
-            if(max(y1,y2) <= 7)
-                setPixel(idx, max(x1,x2)-i, max(y1,y2), red, green, blue);
-            
-            if(min(y1,y2) >= 0)
-                setPixel(idx, max(x1,x2)-i, min(y1,y2), red, green, blue);
-            }
-        }
-        
-    for(int i=0; i<=(abs(y2-y1)); i++){ // draws verticle lines
-        if ((max(y1,y2)-i) >= 0 && max(y1, y2) -i <=7){
-            if(max(x1,x2) <= 7)
-                setPixel(idx, max(x1,x2), max(y1,y2)-i, red, green, blue);
-            
-            if(min(x1,x2) >= 0)
-                setPixel(idx, min(x1,x2), max(y1,y2)-i, red, green, blue);
-            }
-        }
+    // note: drawRect does not use drawLine function because the angles will always be 90 degrees, so the
+    // sides are clipped once and the left and right ones are filled as column spans
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return;
+    int xl = min(x1,x2), xh = max(x1,x2);
+    int yl = min(y1,y2), yh = max(y1,y2);
+
+    for (int x = max(xl, 0); x <= min(xh, clipW-1); x++)   // draws horizontal lines
+    {
+        dot(ox, oy, x, yh, red, green, blue);
+        dot(ox, oy, x, yl, red, green, blue);
+    }
+
+    int bottom = max(yl, 0);    // draws verticle lines
+    int top = min(yh, clipH-1);
+    if (bottom > top)
+        return;
+    if (xh >= 0 && xh < clipW)
+        fillColumn(ox+xh, oy+bottom, oy+top, red, green, blue);
+    if (xl >= 0 && xl < clipW && xl != xh)
+        fillColumn(ox+xl, oy+bottom, oy+top, red, green, blue);
 }
 
 
@@ -146,16 +425,19 @@ void NeoArr::drawFilledRect(int idx, int x1, int y1, int x2, int y2, int color)
 
 void NeoArr::drawFilledRect(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue)
 {
-    for(int i=0; i<=(abs(x2-x1)); i++){
-        if ((max(x1,x2)-i) >= 0 && max(x1, x2) -i <=7){
-            for(int n=0; n<=(abs(y2-y1)); n++){
-                if((max(y1,y2)-n) >= 0 && max(y1, y2)-n <=7){
-                    setPixel(idx, max(x1,x2)-i, max(y1,y2)-n, red, green, blue);
-                }
-            }
-        }
-    }
-    
+    // clip to the board once, then fill each column as one span
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return;
+    int xl = max(min(x1,x2), 0);
+    int xh = min(max(x1,x2), clipW-1);
+    int yl = max(min(y1,y2), 0);
+    int yh = min(max(y1,y2), clipH-1);
+    if (xl > xh || yl > yh)
+        return;
+
+    for(int x=xl; x<=xh; x++)
+        fillColumn(ox+x, oy+yl, oy+yh, red, green, blue);
 }
 
 void NeoArr::fillScreen(int idx, int color)
@@ -169,9 +451,13 @@ void NeoArr::fillScreen(int idx, int color)
 
 void NeoArr::fillScreen(int idx,uint8_t red, uint8_t green, uint8_t blue)
 {    
-   for(int i=0; i<8; i++)
-        for(int n=0; n<8; n++)
-            setPixel(idx, i, n, red, green, blue);
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return;
+    int pixel = map[ox*height + oy] & ~63;      // a board is 64 pixels in a row whatever its orientation
+    int n = (idx == NEO_CANVAS) ? tiles*64 : 64;
+    fill(pixel, n, red, green, blue);
+    touch(pixel, pixel + n - 1);
 }
 
 
@@ -204,21 +490,587 @@ void NeoArr::drawFilledTriangle(int idx, int x1, int y1, int x2, int y2, int x3,
 
 void NeoArr::drawFilledTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, uint8_t red, uint8_t green, uint8_t blue)
 {
-    // note: drawFilledTriangle draws two legs of the triangle and then draws lines from their corner to each point on the opposite leg
-    drawLine(idx, x1, y1, x2, y2, red, green, blue);
-    drawLine(idx, x2, y2, x3, y3, red, green, blue);
+    // note: the edges are walked column by column in exact integer steps and each column is filled as one span
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return;
+
+    int area = (x2-x1)*(y3-y1) - (y2-y1)*(x3-x1);
+    if (area == 0)
+        return;     // no pixel centres inside a flat triangle
+    if (area < 0)
+    {
+        int t = x2; x2 = x3; x3 = t;    // make the corners run counter clockwise
+        t = y2; y2 = y3; y3 = t;
+    }
+
+    // edge i is a*x + b*y + c >= 0 on the inside; n[i] = a*x + c is walked along x
+    int px[3] = {x1, x2, x3};
+    int py[3] = {y1, y2, y3};
+    int a[3], b[3], n[3];
+    int xl = max(min(x1, min(x2, x3)), 0);
+    int xh = min(max(x1, max(x2, x3)), clipW-1);
+    for (int i = 0; i < 3; i++)
+    {
+        int j = (i + 1) % 3;
+        int dx = px[j] - px[i];
+        int dy = py[j] - py[i];
+        a[i] = -dy;
+        b[i] = dx;
+        n[i] = a[i]*xl + dy*px[i] - dx*py[i];
+
+        // fill rule: an edge on the low side of the columns, or a vertical edge on
+        // their left, keeps the centres it passes through; the others give them up
+        // so triangles sharing an edge never write the same pixel twice
+        if (!(b[i] > 0 || (b[i] == 0 && a[i] > 0)))
+            n[i] -= 1;
+    }
+
+    for (int x = xl; x <= xh; x++)
+    {
+        int yl = 0;
+        int yh = clipH-1;
+        for (int i = 0; i < 3; i++)
+        {
+            if (b[i] > 0)
+                yl = max(yl, ceilDiv(-n[i], b[i]));
+            else if (b[i] < 0)
+                yh = min(yh, floorDiv(n[i], -b[i]));
+            else if (n[i] < 0)
+                yh = -1;                // column outside a vertical edge
+            n[i] += a[i];
+        }
+        if (yl <= yh)
+            fillColumn(ox+x, oy+yl, oy+yh, red, green, blue);
+    }
+}
+
+// widens the half heights of columns x - dx and x + dx, of the n being drawn on, to at least h
+static void widen(int *ext, int n, int x, int dx, int h)
+{
+    if ((unsigned)(x - dx) < (unsigned)n && ext[x - dx] < h)
+        ext[x - dx] = h;
+    if ((unsigned)(x + dx) < (unsigned)n && ext[x + dx] < h)
+        ext[x + dx] = h;
+}
+
+// fills each column that has a half height, centred on row y
+void NeoArr::fillExtents(int ox, int oy, int y, const int *ext, uint8_t red, uint8_t green, uint8_t blue)
+{
+    for (int x = 0; x < clipW; x++)
+    {
+        if (ext[x] < 0)
+            continue;
+        int y0 = max(y - ext[x], 0);
+        int y1 = min(y + ext[x], clipH-1);
+        if (y0 <= y1)
+            fillColumn(ox + x, oy + y0, oy + y1, red, green, blue);
+    }
+}
+
+void NeoArr::drawCircle(int idx, int x, int y, int r, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
     
+    drawCircle(idx, x, y, r, red, green, blue);
+}
+
+void NeoArr::drawCircle(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue)
+{
+    // note: midpoint circle; one octant is walked and mirrored into the other seven
+    int ox, oy;
+    if (r < 0 || !origin(idx, ox, oy))
+        return;
+
+    int dx = 0;
+    int dy = r;
+    int d = 1 - r;
+    while (dx <= dy)
+    {
+        dot(ox, oy, x + dx, y + dy, red, green, blue);
+        dot(ox, oy, x - dx, y + dy, red, green, blue);
+        dot(ox, oy, x + dx, y - dy, red, green, blue);
+        dot(ox, oy, x - dx, y - dy, red, green, blue);
+        dot(ox, oy, x + dy, y + dx, red, green, blue);
+        dot(ox, oy, x - dy, y + dx, red, green, blue);
+        dot(ox, oy, x + dy, y - dx, red, green, blue);
+        dot(ox, oy, x - dy, y - dx, red, green, blue);
+        if (d < 0)
+            d += 2*dx + 3;
+        else
+        {
+            d += 2*(dx - dy) + 5;
+            dy--;
+        }
+        dx++;
+    }
+}
+
+void NeoArr::drawFilledCircle(int idx, int x, int y, int r, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+    
+    drawFilledCircle(idx, x, y, r, red, green, blue);
+}
+
+void NeoArr::drawFilledCircle(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue)
+{
+    // note: the midpoint walk gives the half height of every column, then each column is one span
+    int ox, oy;
+    if (r < 0 || !origin(idx, ox, oy))
+        return;
+
+    int *ext = extents;
+    for (int i = 0; i < clipW; i++)
+        ext[i] = -1;
+    int dx = 0;
+    int dy = r;
+    int d = 1 - r;
+    while (dx <= dy)
+    {
+        widen(ext, clipW, x, dx, dy);
+        widen(ext, clipW, x, dy, dx);
+        if (d < 0)
+            d += 2*dx + 3;
+        else
+        {
+            d += 2*(dx - dy) + 5;
+            dy--;
+        }
+        dx++;
+    }
+    fillExtents(ox, oy, y, ext, red, green, blue);
+}
+
+// walks a midpoint ellipse; with ext it widens the column half heights, otherwise
+// it plots the outline. The decision values are kept at four times their size so
+// they stay whole numbers.
+void NeoArr::ellipse(int ox, int oy, int x, int y, int rx, int ry, int *ext, uint8_t red, uint8_t green, uint8_t blue)
+{
+    long long rx2 = (long long)rx * rx;
+    long long ry2 = (long long)ry * ry;
+    int dx = 0;
+    int dy = ry;
+    long long px = 0;               // 2*ry2*dx
+    long long py = 2 * rx2 * dy;    // 2*rx2*dy
+    bool region1 = true;            // the curve is flatter than 45 degrees
+
+    long long p = 4*ry2 - 4*rx2*ry + rx2;
+    while (dy >= 0)
+    {
+        if (ext)
+            widen(ext, clipW, x, dx, dy);
+        else
+        {
+            dot(ox, oy, x + dx, y + dy, red, green, blue);
+            dot(ox, oy, x - dx, y + dy, red, green, blue);
+            dot(ox, oy, x + dx, y - dy, red, green, blue);
+            dot(ox, oy, x - dx, y - dy, red, green, blue);
+        }
+
+        if (region1)
+        {
+            dx++;
+            px += 2*ry2;
+            if (p < 0)
+                p += 4*(ry2 + px);
+            else
+            {
+                dy--;
+                py -= 2*rx2;
+                p += 4*(ry2 + px - py);
+            }
+            if (px >= py)
+            {
+                // on to region 2, stepping down y
+                region1 = false;
+                p = ry2*(2*dx + 1)*(2*dx + 1) + 4*rx2*(long long)(dy - 1)*(dy - 1) - 4*rx2*ry2;
+            }
+        }
+        else
+        {
+            dy--;
+            py -= 2*rx2;
+            if (p > 0)
+                p += 4*(rx2 - py);
+            else
+            {
+                dx++;
+                px += 2*ry2;
+                p += 4*(rx2 - py + px);
+            }
+        }
+    }
+}
+
+void NeoArr::drawEllipse(int idx, int x, int y, int rx, int ry, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+    
+    drawEllipse(idx, x, y, rx, ry, red, green, blue);
+}
+
+void NeoArr::drawEllipse(int idx, int x, int y, int rx, int ry, uint8_t red, uint8_t green, uint8_t blue)
+{
+    int ox, oy;
+    if (rx < 0 || ry < 0 || !origin(idx, ox, oy))
+        return;
+    if (rx == 0 || ry == 0)
+    {
+        drawFilledEllipse(idx, x, y, rx, ry, red, green, blue);     // a flat ellipse is a line
+        return;
+    }
+    ellipse(ox, oy, x, y, rx, ry, NULL, red, green, blue);
+}
+
+void NeoArr::drawFilledEllipse(int idx, int x, int y, int rx, int ry, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+    
+    drawFilledEllipse(idx, x, y, rx, ry, red, green, blue);
+}
+
+void NeoArr::drawFilledEllipse(int idx, int x, int y, int rx, int ry, uint8_t red, uint8_t green, uint8_t blue)
+{
+    int ox, oy;
+    if (rx < 0 || ry < 0 || !origin(idx, ox, oy))
+        return;
+
+    int *ext = extents;
+    for (int i = 0; i < clipW; i++)
+        ext[i] = -1;
+    if (rx == 0 || ry == 0)
+    {
+        for (int dx = 0; dx <= rx; dx++)
+            widen(ext, clipW, x, dx, ry);
+    }
+    else
+        ellipse(ox, oy, x, y, rx, ry, ext, red, green, blue);
+    fillExtents(ox, oy, y, ext, red, green, blue);
+}
+
+// true if the direction (dx, dy) lies in the counter clockwise sweep from s to e;
+// wide is set when the sweep is more than half a turn
+static bool inSweep(int dx, int dy, int sx, int sy, int ex, int ey, bool wide)
+{
+    bool afterStart = (long long)sx*dy - (long long)sy*dx >= 0;
+    bool beforeEnd = (long long)dx*ey - (long long)dy*ex >= 0;
+    return wide ? (afterStart || beforeEnd) : (afterStart && beforeEnd);
+}
+
+// unit vector of an angle in degrees, scaled to 4096, and whether end is more than half a turn on from start
+static bool sweep(int start, int end, int &sx, int &sy, int &ex, int &ey)
+{
+    const float rad = 3.14159265f / 180.0f;
+    sx = (int)floor(4096.0f * cos(start * rad) + 0.5f);
+    sy = (int)floor(4096.0f * sin(start * rad) + 0.5f);
+    ex = (int)floor(4096.0f * cos(end * rad) + 0.5f);
+    ey = (int)floor(4096.0f * sin(end * rad) + 0.5f);
+    int span = (end - start) % 360;
+    if (span < 0)
+        span += 360;
+    return span > 180;
+}
+
+void NeoArr::drawArc(int idx, int x, int y, int r, int start, int end, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+    
+    drawArc(idx, x, y, r, start, end, red, green, blue);
+}
+
+void NeoArr::drawArc(int idx, int x, int y, int r, int start, int end, uint8_t red, uint8_t green, uint8_t blue)
+{
+    // note: the midpoint circle points are kept when their direction is inside the sweep;
+    // the end directions are worked out once, so each point costs two cross products
+    if (end - start >= 360)
+    {
+        drawCircle(idx, x, y, r, red, green, blue);
+        return;
+    }
+    int ox, oy;
+    if (r < 0 || !origin(idx, ox, oy))
+        return;
+
+    int sx, sy, ex, ey;
+    bool wide = sweep(start, end, sx, sy, ex, ey);
+    int dx = 0;
+    int dy = r;
+    int d = 1 - r;
+    while (dx <= dy)
+    {
+        int px[8] = {dx, -dx, dx, -dx, dy, -dy, dy, -dy};
+        int py[8] = {dy, dy, -dy, -dy, dx, dx, -dx, -dx};
+        for (int k = 0; k < 8; k++)
+            if (inSweep(px[k], py[k], sx, sy, ex, ey, wide))
+                dot(ox, oy, x + px[k], y + py[k], red, green, blue);
+        if (d < 0)
+            d += 2*dx + 3;
+        else
+        {
+            d += 2*(dx - dy) + 5;
+            dy--;
+        }
+        dx++;
+    }
+}
+
+void NeoArr::drawFilledArc(int idx, int x, int y, int r, int start, int end, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+    
+    drawFilledArc(idx, x, y, r, start, end, red, green, blue);
+}
+
+void NeoArr::drawFilledArc(int idx, int x, int y, int r, int start, int end, uint8_t red, uint8_t green, uint8_t blue)
+{
+    // note: the columns of the filled circle are walked and each pixel is kept when inside the sweep
+    if (end - start >= 360)
+    {
+        drawFilledCircle(idx, x, y, r, red, green, blue);
+        return;
+    }
+    int ox, oy;
+    if (r < 0 || !origin(idx, ox, oy))
+        return;
+
+    int *ext = extents;
+    for (int i = 0; i < clipW; i++)
+        ext[i] = -1;
+    int dx = 0;
+    int dy = r;
+    int d = 1 - r;
+    while (dx <= dy)
+    {
+        widen(ext, clipW, x, dx, dy);
+        widen(ext, clipW, x, dy, dx);
+        if (d < 0)
+            d += 2*dx + 3;
+        else
+        {
+            d += 2*(dx - dy) + 5;
+            dy--;
+        }
+        dx++;
+    }
+
+    int sx, sy, ex, ey;
+    bool wide = sweep(start, end, sx, sy, ex, ey);
+    for (int px = 0; px < clipW; px++)
+        for (int py = max(y - ext[px], 0); py <= min(y + ext[px], clipH-1); py++)
+            if (ext[px] >= 0 && ((px == x && py == y) || inSweep(px - x, py - y, sx, sy, ex, ey, wide)))
+                dot(ox, oy, px, py, red, green, blue);
+}
+
+// integer square root, rounded down
+static uint32_t isqrt(uint32_t v)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v)
+        bit >>= 2;
+    while (bit)
+    {
+        if (v >= root + bit)
+        {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+        bit >>= 2;
+    }
+    return root;
+}
+
+void NeoArr::drawLineAA(int idx, int x1, int y1, int x2, int y2, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
     
-    float k;
-    int j = rint(sqrt(pow((x1-x3),2.0) + pow((y1-y3),2.0)));    // magnitude of opposite leg
-    if(x1 != x3)
-        k = atan2( (float)(y3-y1),(float) ( x3-x1));    // angle of line of opposite leg
+    drawLineAA(idx, x1, y1, x2, y2, red, green, blue);
+}
+
+void NeoArr::drawLineAA(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue)
+{
+    // note: the minor axis position is kept in 16.16 fixed point; its fraction is the share of the second pixel
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return;
+
+    bool steep = abs(y2-y1) > abs(x2-x1);
+    int a1 = steep ? y1 : x1, b1 = steep ? x1 : y1;
+    int a2 = steep ? y2 : x2, b2 = steep ? x2 : y2;
+    if (a1 > a2)
+    {
+        int t = a1; a1 = a2; a2 = t;        // always walk up the major axis
+        t = b1; b1 = b2; b2 = t;
+    }
+    int da = a2 - a1;
+    int sb = (b2 < b1) ? -1 : 1;
+
+    // the end points are exact
+    if (steep)
+    {
+        shade(ox, oy, b1, a1, red, green, blue, 255);
+        shade(ox, oy, b2, a2, red, green, blue, 255);
+    }
     else
-        k = acos(0.0);
-        
-    for(float n=0; n<=j; n++)
-        if((x1+ rint(n*cos(k))) >=0 && (x1+rint( n*cos(k))) <=7 &&  (y1+rint(n*sin(k)))>=0 &&  (y1+rint(n*sin(k)))<=7)
-            drawLine(idx, x1+ rint(n*cos(k)), y1+ rint(n*sin(k)), x2, y2, red, green, blue);    // draw line from corner to each point on opposite leg
+    {
+        shade(ox, oy, a1, b1, red, green, blue, 255);
+        shade(ox, oy, a2, b2, red, green, blue, 255);
+    }
+    if (da < 2)
+        return;
+
+    uint32_t adj = ((uint32_t)abs(b2-b1) << 16) / da;     // minor axis step per major step
+    uint32_t acc = 0;
+    int b = b1;
+    for (int a = a1 + 1; a < a2; a++)
+    {
+        acc += adj;
+        if (acc >= 0x10000)
+        {
+            acc -= 0x10000;
+            b += sb;
+        }
+        int w = acc >> 8;                   // share of the pixel one step further along the minor axis
+        if (steep)
+        {
+            shade(ox, oy, b, a, red, green, blue, 255 - w);
+            shade(ox, oy, b + sb, a, red, green, blue, w);
+        }
+        else
+        {
+            shade(ox, oy, a, b, red, green, blue, 255 - w);
+            shade(ox, oy, a, b + sb, red, green, blue, w);
+        }
+    }
+}
+
+void NeoArr::drawCircleAA(int idx, int x, int y, int r, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+    
+    drawCircleAA(idx, x, y, r, red, green, blue);
+}
+
+void NeoArr::drawCircleAA(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue)
+{
+    // note: a pixel is lit by 1 - |d - r| where d is the distance of its centre, in 8.8 fixed point
+    int ox, oy;
+    if (r < 0 || r > 254 || !origin(idx, ox, oy))
+        return;
+
+    int inner = (r > 0) ? (r - 1)*(r - 1) : -1;
+    int outer = (r + 1)*(r + 1);
+    for (int px = max(x - r, 0); px <= min(x + r, clipW-1); px++)
+        for (int py = max(y - r, 0); py <= min(y + r, clipH-1); py++)
+        {
+            int d2 = (px - x)*(px - x) + (py - y)*(py - y);
+            if (d2 <= inner || d2 >= outer)
+                continue;
+            int diff = abs((int)isqrt((uint32_t)d2 << 16) - (r << 8));
+            if (diff < 256)
+                shade(ox, oy, px, py, red, green, blue, ((256 - diff)*255) >> 8);
+        }
+}
+
+void NeoArr::drawFilledCircleAA(int idx, int x, int y, int r, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+    
+    drawFilledCircleAA(idx, x, y, r, red, green, blue);
+}
+
+void NeoArr::drawFilledCircleAA(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue)
+{
+    // note: a pixel is covered by r + 1/2 - d where d is the distance of its centre, in 8.8 fixed point
+    int ox, oy;
+    if (r < 0 || r > 254 || !origin(idx, ox, oy))
+        return;
+
+    int inner = (r > 0) ? (r - 1)*(r - 1) : -1;     // centres this close are covered completely
+    int outer = (r + 1)*(r + 1);
+    for (int px = max(x - r, 0); px <= min(x + r, clipW-1); px++)
+        for (int py = max(y - r, 0); py <= min(y + r, clipH-1); py++)
+        {
+            int d2 = (px - x)*(px - x) + (py - y)*(py - y);
+            if (d2 >= outer)
+                continue;
+            int cover = (d2 <= inner) ? 256 : (r << 8) + 128 - (int)isqrt((uint32_t)d2 << 16);
+            if (cover > 0)
+                shade(ox, oy, px, py, red, green, blue, (min(cover, 256)*255) >> 8);
+        }
+}
+
+void NeoArr::drawFilledTriangleAA(int idx, int x1, int y1, int x2, int y2, int x3, int y3, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+    
+    drawFilledTriangleAA(idx, x1, y1, x2, y2, x3, y3, red, green, blue);
+}
+
+void NeoArr::drawFilledTriangleAA(int idx, int x1, int y1, int x2, int y2, int x3, int y3, uint8_t red, uint8_t green, uint8_t blue)
+{
+    // note: each edge covers 1/2 plus the distance of the pixel centre inside it, and a pixel takes the least of the three
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return;
+
+    int area = (x2-x1)*(y3-y1) - (y2-y1)*(x3-x1);
+    if (area == 0)
+        return;
+    if (area < 0)
+    {
+        int t = x2; x2 = x3; x3 = t;    // make the corners run counter clockwise
+        t = y2; y2 = y3; y3 = t;
+    }
+
+    // edge i is a*x + b*y + c, positive inside; scale turns it into 1/255ths of a pixel, in 8.8 fixed point
+    int px[3] = {x1, x2, x3};
+    int py[3] = {y1, y2, y3};
+    int a[3], b[3], c[3], scale[3];
+    for (int i = 0; i < 3; i++)
+    {
+        int j = (i + 1) % 3;
+        a[i] = py[i] - py[j];
+        b[i] = px[j] - px[i];
+        c[i] = -a[i]*px[i] - b[i]*py[i];
+        scale[i] = (255 << 16) / (int)isqrt((uint32_t)(a[i]*a[i] + b[i]*b[i]) << 16);
+    }
+
+    int xl = max(min(x1, min(x2, x3)), 0);
+    int xh = min(max(x1, max(x2, x3)), clipW-1);
+    int yl = max(min(y1, min(y2, y3)), 0);
+    int yh = min(max(y1, max(y2, y3)), clipH-1);
+    for (int x = xl; x <= xh; x++)
+        for (int y = yl; y <= yh; y++)
+        {
+            int cover = 255;
+            for (int i = 0; i < 3; i++)
+                cover = min(cover, 128 + ((a[i]*x + b[i]*y + c[i]) * scale[i] >> 8));
+            shade(ox, oy, x, y, red, green, blue, cover);
+        }
 }
 
 void NeoArr::drawChar(int idx, int x, int y, char c, int color)
@@ -230,10 +1082,8 @@ void NeoArr::drawChar(int idx, int x, int y, char c, int color)
     drawChar(idx, x, y, c, red, green, blue);
 }
 
-void NeoArr::drawChar(int idx, int x, int y, char c, uint8_t red, uint8_t green, uint8_t blue)
+const uint8_t *neo_glyph(char c)
 {
-    uint8_t i,j;
-    
     c = c & 0x7F;  // mask c to avoid errors
     
     if (c < ' ') {  // convert c into index of font array
@@ -243,46 +1093,701 @@ void NeoArr::drawChar(int idx, int x, int y, char c, uint8_t red, uint8_t green,
     }
 
     // font is BMplain, a 96x6 array stored in font.h, many free available fonts are online and can be swapped into this font
-    const uint8_t* chr = font[c];
+    return font[(int)c];
+}
 
-    for (j=0; j<6; j++) {   // character width is 6
-        for (i=0; i<8; i++) {   // character height is 8
-            if (chr[j] & (1<<i)) {  // if there is a pixel in the vertical line, set pixel on board
-                if((x+j) <= 7 && (x+j)>=0 && (y+7-i)>=0 && (y+7-i) <=7)
-                     setPixel(0, x+j, y+ 7-i, red,green,blue);
-            }
+uint64_t neo_glyph_rows(char c)
+{
+    // transposed copies of the font.h columns, 768 bytes of RAM
+    static uint64_t rows[96];
+    static bool built = false;
+    if (!built)
+    {
+        for (int g = 0; g < 96; g++)
+        {
+            rows[g] = 0;
+            for (int j = 0; j < 6; j++)
+                for (int i = 0; i < 8; i++)
+                    if (font[g][j] & (1<<i))
+                        rows[g] |= (uint64_t)1 << ((7-i)*8 + j);
         }
+        built = true;
     }
+    return rows[(neo_glyph(c) - font[0]) / 6];
+}
+
+void NeoArr::drawChar(int idx, int x, int y, char c, uint8_t red, uint8_t green, uint8_t blue)
+{
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return;
+
+    // clip the whole glyph with one mask: the columns on the board in every row on it
+    int xl = max(x, 0) - x;
+    int xh = min(x + 5, clipW - 1) - x;
+    int yl = max(y, 0) - y;
+    int yh = min(y + 7, clipH - 1) - y;
+    if (xl > xh || yl > yh)
+        return;
+    uint32_t cols = ((2u << xh) - (1u << xl)) * 0x01010101u;
+    uint64_t mask = ((uint64_t)cols << 32) | cols;
+    uint64_t bits = neo_glyph_rows(c) & mask & ((~(uint64_t)0 >> (56 - 8*yh)) << (8*yl));
+
+    // start at the first row and column on the board, so pixel only points at ones on it
+    bits >>= 8*yl;
+    for (int i = yl; bits; i++, bits >>= 8)
+    {
+        uint8_t row = (bits & 0xFF) >> xl;
+        const uint16_t *pixel = &map[(ox+x+xl)*height + oy+y+i];
+        for (int j = 0; row; j++, row >>= 1)
+            if (row & 1)
+                put(pixel[j*height], red, green, blue);
+    }
+}
+
+int NeoArr::drawText(int idx, int x, int y, const char *text, const NeoFont &font, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+
+    return drawText(idx, x, y, text, font, red, green, blue);
+}
+
+int NeoArr::drawText(int idx, int x, int y, const char *text, const NeoFont &font, uint8_t red, uint8_t green, uint8_t blue)
+{
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return x + neo_text_width(font, text);
+
+    // rows of the font on the board, as a mask of the column bits to draw; the
+    // bits are shifted down to the first of them, yl, so col only points at rows on it
+    int yl = max(y, 0);
+    int yh = min(y + font.height - 1, clipH - 1);
+    uint32_t rows = (yl <= yh) ? ((2u << (yh - y)) - (1u << (yl - y))) : 0;
+
+    uint32_t c = neo_utf8_next(text);
+    while (c)
+    {
+        uint32_t next = neo_utf8_next(text);
+        const NeoGlyph &g = neo_font_glyph(font, c);
+        int gx = x + g.left;
+        int first = max(0, -gx);
+        int last = min((int)g.width, clipW - gx);
+        uint32_t bit = g.offset + first * font.height;
+        for (int j = first; j < last && rows; j++, bit += font.height)
+        {
+            // note: the same read as neo_font_column(), kept inline as it runs for every column drawn
+            const uint8_t *p = font.bitmap + (bit >> 3);
+            uint32_t bits = (((p[0] | (p[1] << 8) | (p[2] << 16)) >> (bit & 7)) & rows) >> (yl - y);
+            const uint16_t *col = &map[(ox+gx+j)*height + oy + yl];
+            for (int b = 0; bits; b++, bits >>= 1)
+                if (bits & 1)
+                    put(col[b], red, green, blue);
+        }
+        x += g.advance;
+        if (next)
+            x += neo_font_kern(font, c, next);
+        c = next;
+    }
+    return x;
 }
 
 void NeoArr::showImage(int idx, const int *img)
 {
-    int r, g, b;
-    for (int i = 0; i < 8; i++)
-        for(int n=0; n<8;n++){
-        r = (img[i] & 0xFF0000) >> 16;
-        g = (img[i] & 0x00FF00) >>8;
-        b = img[i] & 0x0000FF;
-        setPixel(idx,i,n, r, g, b);
+    NeoSprite image = {img, NULL, 8, 8, NEO_SPRITE_COLOR, 0, 0};
+    blit(idx, 0, 0, image);
+}
+
+// palette entry of a MONO or INDEXED pixel
+static int paletteColor(const NeoSprite &s, int v)
+{
+    if (s.palette)
+        return s.palette[v];
+    return (s.format == NEO_SPRITE_MONO) ? (v ? 0xFFFFFF : 0) : v * 0x010101;
+}
+
+// decodes n pixels of sprite column col from row up, into run unless they can be
+// used in place; returns the pixels and sets bit k of opaque for each drawn pixel
+static const NeoColor *decodeColumn(const NeoSprite &s, int col, int row, int n, NeoColor *run, uint32_t &opaque)
+{
+    bool key = (s.flags & NEO_SPRITE_KEY) != 0;
+    int first = col * s.height + row;
+    uint32_t v;
+    int color;
+    opaque = 0;
+
+    if (s.format == NEO_SPRITE_RGB888)
+    {
+        const NeoColor *px = (const NeoColor*)s.data + first;
+        for (int k = 0; k < n; k++)
+            if (!key || (uint32_t)((px[k].red << 16) | (px[k].green << 8) | px[k].blue) != s.key)
+                opaque |= 1 << k;
+        return px;
+    }
+
+    if (s.format == NEO_SPRITE_MONO)
+    {
+        // the two colors are looked up once for the whole run
+        const uint8_t *bits = (const uint8_t*)s.data + col * ((s.height + 7) / 8);
+        NeoColor ink[2];
+        for (int v = 0; v < 2; v++)
+        {
+            color = paletteColor(s, v);
+            ink[v].red = color >> 16;
+            ink[v].green = color >> 8;
+            ink[v].blue = color;
+        }
+        uint32_t word = bits[row >> 3] | (bits[(row + n - 1) >> 3] << 8);      // a run of at most 8 rows spans two bytes
+        word >>= row & 7;
+        for (int k = 0; k < n; k++, word >>= 1)
+        {
+            v = word & 1;
+            if (key && v == s.key)
+                continue;
+            opaque |= 1 << k;
+            run[k] = ink[v];
+        }
+        return run;
+    }
+
+    for (int k = 0; k < n; k++)
+    {
+        switch (s.format)
+        {
+            case NEO_SPRITE_RGB565:
+                v = ((const uint16_t*)s.data)[first + k];
+                color = ((v & 0xF800) << 8) | ((v & 0xE000) << 3)      // 5 bits of red, repeated at the bottom
+                      | ((v & 0x07E0) << 5) | ((v & 0x0600) >> 1)      // 6 bits of green
+                      | ((v & 0x001F) << 3) | ((v & 0x001C) >> 2);     // 5 bits of blue
+                break;
+            case NEO_SPRITE_INDEXED:
+                v = ((const uint8_t*)s.data)[first + k];
+                color = paletteColor(s, v);
+                break;
+            default:
+                color = ((const int*)s.data)[first + k] & 0xFFFFFF;
+                v = color;
+                break;
+        }
+        if (key && v == s.key)
+            continue;
+        opaque |= 1 << k;
+        run[k].red = color >> 16;
+        run[k].green = color >> 8;
+        run[k].blue = color;
+    }
+    return run;
+}
+
+void NeoArr::blit(int idx, int x, int y, const NeoSprite &sprite, uint8_t alpha)
+{
+    blit(idx, x, y, sprite, 0, 0, sprite.width, sprite.height, alpha);
+}
+
+void NeoArr::blit(int idx, int x, int y, const NeoSprite &sprite, int sx, int sy, int w, int h, uint8_t alpha)
+{
+    // clip the part to the sprite and then to the board, once
+    int ox, oy;
+    if (!origin(idx, ox, oy))
+        return;
+    if (sx < 0) { x -= sx; w += sx; sx = 0; }
+    if (sy < 0) { y -= sy; h += sy; sy = 0; }
+    w = min(w, sprite.width - sx);
+    h = min(h, sprite.height - sy);
+    if (x < 0) { sx -= x; w += x; x = 0; }
+    if (y < 0) { sy -= y; h += y; y = 0; }
+    w = min(w, clipW - x);
+    h = min(h, clipH - y);
+    if (w <= 0 || h <= 0 || alpha == 0)
+        return;
+
+    NeoColor run[8];
+    uint32_t opaque;
+    for (int c = 0; c < w; c++)
+        for (int k = 0; k < h; )
+        {
+            // one board's rows of the column at a time
+            int n = min(h - k, 8 - ((oy + y + k) & 7));
+            const NeoColor *px = decodeColumn(sprite, sx + c, sy + k, n, run, opaque);
+            const uint16_t *dst = &map[(ox + x + c)*height + oy + y + k];
+            k += n;
+
+            if (opaque == (1u << n) - 1 && alpha == 255 && !index && dst[n-1] - dst[0] == n - 1)
+            {
+                // the board column runs up the canvas, so the whole run is one copy
+                memcpy(&arr[dst[0]], px, n * sizeof(NeoColor));
+                touch(dst[0], dst[n-1]);
+            }
+            else
+            {
+                for (int i = 0; i < n; i++)
+                    if (opaque & (1 << i))
+                    {
+                        if (alpha == 255)
+                            put(dst[i], px[i].red, px[i].green, px[i].blue);
+                        else
+                            blend(dst[i], px[i].red, px[i].green, px[i].blue, alpha);
+                    }
+            }
+        }
+}
+
+NeoColor *NeoArr::column(int idx, int x)
+{
+    int pixel = idx*64 + x*8;
+    int n = 8;
+    if (x < 0 || x > 7 || !clip(pixel, n) || n != 8 || index)
+        return NULL;
+    touch(pixel, pixel + 7);
+    return &arr[pixel];
+}
+
+void NeoArr::writeSpan(int idx, int x, int y, const NeoColor *src, int n)
+{
+    int pixel = idx*64 + x*8 + y;
+    int first = pixel;
+    if (!clip(pixel, n))
+        return;
+    src += pixel - first;
+    if (index)
+    {
+        for (int i = 0; i < n; i++)
+            index[pixel + i] = src[i].blue;
     }
+    else
+        memcpy(&arr[pixel], src, n * sizeof(NeoColor));
+    touch(pixel, pixel + n - 1);
+}
+
+void NeoArr::fillSpan(int idx, int x, int y, int n, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+
+    fillSpan(idx, x, y, n, red, green, blue);
+}
+
+void NeoArr::fillSpan(int idx, int x, int y, int n, uint8_t red, uint8_t green, uint8_t blue)
+{
+    int pixel = idx*64 + x*8 + y;
+    if (!clip(pixel, n))
+        return;
+    fill(pixel, n, red, green, blue);
+    touch(pixel, pixel + n - 1);
+}
+
+void NeoArr::scroll(int dx, int dy, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+
+    scroll(0, 0, width, height, dx, dy, red, green, blue);
+}
+
+void NeoArr::scroll(int dx, int dy, uint8_t red, uint8_t green, uint8_t blue)
+{
+    scroll(0, 0, width, height, dx, dy, red, green, blue);
+}
+
+void NeoArr::scroll(int x, int y, int w, int h, int dx, int dy, int color)
+{
+    int red = (color & 0xFF0000) >> 16;
+    int green = (color & 0x00FF00) >> 8;
+    int blue = (color & 0x0000FF);
+
+    scroll(x, y, w, h, dx, dy, red, green, blue);
+}
+
+void NeoArr::scroll(int x, int y, int w, int h, int dx, int dy, uint8_t red, uint8_t green, uint8_t blue)
+{
+    if (!clipRect(x, y, w, h) || (dx == 0 && dy == 0))
+        return;
+    if (abs(dx) >= w || abs(dy) >= h)
+    {
+        // everything moves out of the region
+        for (int c = x; c < x + w; c++)
+            fillColumn(c, y, y + h - 1, red, green, blue);
+        return;
+    }
+
+    move(x, y, w, h, dx, dy);
+
+    // uncovered columns, then the uncovered rows of the other columns
+    int c0 = (dx > 0) ? x : x + w + dx;
+    for (int c = c0; c < c0 + abs(dx); c++)
+        fillColumn(c, y, y + h - 1, red, green, blue);
+    if (dy != 0)
+    {
+        int r0 = (dy > 0) ? y : y + h + dy;
+        for (int c = x + max(dx, 0); c < x + w + min(dx, 0); c++)
+            fillColumn(c, r0, r0 + abs(dy) - 1, red, green, blue);
+    }
+}
+
+void NeoArr::rotate(int dx, int dy)
+{
+    rotate(0, 0, width, height, dx, dy);
+}
+
+void NeoArr::rotate(int x, int y, int w, int h, int dx, int dy)
+{
+    if (!clipRect(x, y, w, h))
+        return;
+    dx %= w;
+    dy %= h;
+    if (dx < 0)
+        dx += w;
+    if (dy < 0)
+        dy += h;
+    if (dx > w/2)
+        dx -= w;        // the shorter way round keeps the wrapped strip small
+    if (dy > h/2)
+        dy -= h;
+    if (dx == 0 && dy == 0)
+        return;
+
+    if (strip == NULL)
+        return;
+
+    // the columns that leave one side are kept aside and put back on the other
+    if (dx != 0)
+    {
+        int n = abs(dx);
+        copyRect((dx > 0) ? x + w - n : x, y, n, h, strip, true);
+        move(x, y, w, h, dx, 0);
+        copyRect((dx > 0) ? x : x + w - n, y, n, h, strip, false);
+    }
+    if (dy != 0)
+    {
+        int n = abs(dy);
+        copyRect(x, (dy > 0) ? y + h - n : y, w, n, strip, true);
+        move(x, y, w, h, 0, dy);
+        copyRect(x, (dy > 0) ? y : y + h - n, w, n, strip, false);
+    }
+}
+
+// clips a canvas region, returns false if nothing is left
+bool NeoArr::clipRect(int &x, int &y, int &w, int &h) const
+{
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    w = min(w, width - x);
+    h = min(h, height - y);
+    return w > 0 && h > 0;
+}
+
+// moves the pixels of a clipped region by (dx, dy), smaller than the region, dropping
+// those that leave it. Each canvas column is copied in runs that stay on one board
+// column, so a run is a single memmove; columns and runs are taken in the order that
+// reads every pixel before it is overwritten.
+void NeoArr::move(int x, int y, int w, int h, int dx, int dy)
+{
+    int size = index ? 1 : sizeof(NeoColor);
+    uint8_t *base = index ? index : (uint8_t*)arr;
+    int cw = w - abs(dx);
+    int ch = h - abs(dy);
+    int tx = x + max(dx, 0);        // corner the moved pixels end up at
+    int ty = y + max(dy, 0);
+    bool down = dy > 0;             // moving up, so the top row goes first
+
+    if (linear && dy == 0 && h == height)
+    {
+        // whole columns follow each other along the chain, so they all go in one copy
+        memmove(base + tx*height*size, base + (tx - dx)*height*size, cw * height * size);
+        touch(tx*height, (tx + cw)*height - 1);
+        return;
+    }
+
+    for (int i = 0; i < cw; i++)
+    {
+        int c = (dx > 0) ? tx + cw - 1 - i : tx + i;
+        const uint16_t *dst = &map[c*height];
+        const uint16_t *src = &map[(c - dx)*height];
+        int row = down ? ty + ch - 1 : ty;
+        while (row >= ty && row < ty + ch)
+        {
+            // the run ends at the edge of a board, for both the rows it is copied from and to
+            int y0, y1;
+            if (down)
+            {
+                y1 = row;
+                y0 = max(max(ty, y1 & ~7), ((y1 - dy) & ~7) + dy);
+                row = y0 - 1;
+            }
+            else
+            {
+                y0 = row;
+                y1 = min(min(ty + ch - 1, y0 | 7), ((y0 - dy) | 7) + dy);
+                row = y1 + 1;
+            }
+
+            int n = y1 - y0;
+            int a = dst[y0], b = dst[y1];
+            int sa = src[y0 - dy], sb = src[y1 - dy];
+            if (b - a == n && sb - sa == n)         // both board columns run up the canvas
+            {
+                memmove(base + a*size, base + sa*size, (n + 1) * size);
+                touch(a, b);
+            }
+            else if (a - b == n && sa - sb == n)    // both run down the canvas
+            {
+                memmove(base + b*size, base + sb*size, (n + 1) * size);
+                touch(b, a);
+            }
+            else
+            {
+                for (int k = 0; k <= n; k++)
+                {
+                    int yy = down ? y1 - k : y0 + k;
+                    memcpy(base + dst[yy]*size, base + src[yy - dy]*size, size);
+                    touch(dst[yy], dst[yy]);
+                }
+            }
+        }
+    }
+}
+
+// copies a clipped region of the canvas to buf column by column, or back from buf when save is false
+void NeoArr::copyRect(int x, int y, int w, int h, uint8_t *buf, bool save)
+{
+    int size = index ? 1 : sizeof(NeoColor);
+    uint8_t *base = index ? index : (uint8_t*)arr;
+    for (int c = x; c < x + w; c++)
+        for (int r = y; r < y + h; r++, buf += size)
+        {
+            int pixel = map[c*height + r];
+            if (save)
+                memcpy(buf, base + pixel*size, size);
+            else
+            {
+                memcpy(base + pixel*size, buf, size);
+                touch(pixel, pixel);
+            }
+        }
+}
+
+// clips the run [pixel, pixel+n) to the chain, returns false if nothing is left
+bool NeoArr::clip(int &pixel, int &n) const
+{
+    if (pixel < 0)
+    {
+        n += pixel;
+        pixel = 0;
+    }
+    if (pixel + n > N*64)
+        n = N*64 - pixel;
+    return n > 0;
+}
+
+// marks the pixels first to last as changed; frames are sent from pixel 0, so only last matters
+void NeoArr::touch(int, int last)
+{
+    if (last > dirtyMax)
+        dirtyMax = last;
+    if (last > litMax)
+        litMax = last;
+}
+
+// finds the canvas corner of board idx and sets the area the primitive clips to
+bool NeoArr::origin(int idx, int &x, int &y)
+{
+    if (idx == NEO_CANVAS)
+    {
+        x = y = 0;
+        clipW = width;
+        clipH = height;
+        return true;
+    }
+    if (idx < 0 || idx >= tiles)
+        return false;
+    x = (idx % tilesX) * 8;
+    y = (idx / tilesX) * 8;
+    clipW = clipH = 8;
+    return true;
+}
+
+// fills canvas column x from y0 to y1 (already clipped), as chain spans where the layout allows
+void NeoArr::fillColumn(int x, int y0, int y1, uint8_t red, uint8_t green, uint8_t blue)
+{
+    const uint16_t *col = &map[x*height];
+    while (y0 <= y1)
+    {
+        int end = min(y1, y0 | 7);      // last row on this board
+        int a = col[y0];
+        int b = col[end];
+        if (b - a == end - y0)          // board column runs up the canvas
+        {
+            fill(a, end - y0 + 1, red, green, blue);
+            touch(a, b);
+        }
+        else if (a - b == end - y0)     // board column runs down the canvas
+        {
+            fill(b, end - y0 + 1, red, green, blue);
+            touch(b, a);
+        }
+        else                            // board turned on its side
+        {
+            for (int y = y0; y <= end; y++)
+                put(col[y], red, green, blue);
+        }
+        y0 = end + 1;
+    }
+}
+
+// fills an already clipped run, four pixels (three words) at a time
+void NeoArr::fill(int pixel, int n, uint8_t red, uint8_t green, uint8_t blue)
+{
+    NeoColor c;
+    c.red = red;
+    c.green = green;
+    c.blue = blue;
+
+    if (index)
+    {
+        memset(&index[pixel], blue, n);
+        return;
+    }
+
+    NeoColor *p = &arr[pixel];
+    while (n > 0 && (pixel & 3))    // arr is word aligned, so every fourth pixel starts a word
+    {
+        *p++ = c;
+        pixel++;
+        n--;
+    }
+
+    // the pattern g r b g | r b g r | b g r b repeats every 12 bytes (little endian stores)
+    uint32_t w0 = green | (red << 8) | (blue << 16) | (green << 24);
+    uint32_t w1 = red | (blue << 8) | (green << 16) | (red << 24);
+    uint32_t w2 = blue | (green << 8) | (red << 16) | (blue << 24);
+    uint32_t *w = (uint32_t*)p;
+    for (; n >= 4; n -= 4)
+    {
+        w[0] = w0;
+        w[1] = w1;
+        w[2] = w2;
+        w += 3;
+    }
+
+    p = (NeoColor*)w;
+    while (n-- > 0)
+        *p++ = c;
 }
 
 void NeoArr::clear()
 {
-    for (int i = 0; i < (N*64); i++)
+    // pixels past litMax are already 0
+    if (index)
+        memset(index, 0, litMax + 1);
+    else
+        memset(arr, 0, (litMax + 1) * sizeof(NeoColor));
+    if (litMax > dirtyMax)
+        dirtyMax = litMax;
+    litMax = -1;
+}
+
+void NeoArr::invalidate()
+{
+    dirtyMax = N*64 - 1;
+    stale = true;
+}
+
+int NeoArr::render(int n)
+{
+    // the front buffer holds what the strip shows, so only the prefix up to
+    // the last pixel that comes out different has to be sent
+    int last = stale ? n - 1 : -1;
+    int changed = -1;
+    if (index)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            int c = palette[index[i]];
+            uint8_t g = lut[(c >> 8) & 0xFF];
+            uint8_t r = lut[(c >> 16) & 0xFF];
+            uint8_t b = lut[c & 0xFF];
+            if (g != front[i].green || r != front[i].red || b != front[i].blue)
+            {
+                front[i].green = g;
+                front[i].red = r;
+                front[i].blue = b;
+                changed = i;
+            }
+        }
+        stale = false;
+        return max(last, changed) + 1;
+    }
+
+    if (dither)
     {
-        arr[i].red = 0;
-        arr[i].green = 0;
-        arr[i].blue = 0;
+        changed = dither->render(arr, front, n, lut16) - 1;
+        stale = false;
+        return max(last, changed) + 1;
     }
+
+    for (int i = 0; i < n; i++)
+    {
+        uint8_t g = lut[arr[i].green];
+        uint8_t r = lut[arr[i].red];
+        uint8_t b = lut[arr[i].blue];
+        if (g != front[i].green || r != front[i].red || b != front[i].blue)
+        {
+            front[i].green = g;
+            front[i].red = r;
+            front[i].blue = b;
+            changed = i;
+        }
+    }
+    stale = false;
+    return max(last, changed) + 1;
 }
 
 void NeoArr::write()
 {
-    __disable_irq();        // disable interrupts
-    neo_out(arr, Nbytes); // output to the strip
-    __enable_irq();         // enable interrupts
-    wait_us(50);            // wait 50us for the reset pulse
+    NeoProfileScope profile(neo_profile_write);
+
+    int n = dirtyMax + 1;
+    if (dither && dither->temporal() && !index && litMax >= n)
+        n = litMax + 1;     // dithered pixels move every frame
+    if (n == 0)
+        return;             // nothing changed since the last frame
+
+    while (sink->busy());   // the front buffer still belongs to the last frame
+
+    n = render(n);
+    dirtyMax = -1;
+    if (n == 0)
+        return;             // redrawn with the same colors
+
+    sink->write(front, n);  // output to the strip
+    if (!async)
+        while (sink->busy());
+}
+
+void NeoArr::setDoubleBuffer(bool on)
+{
+    async = on;
+}
+
+bool NeoArr::busy() const
+{
+    return sink->busy();
+}
+
+void NeoArr::attach(void (*fn)(void))
+{
+    sink->attach(fn);
 }
 
 
@@ -12,18 +12,31 @@
 #ifndef NEOARRAY_H
 #define NEOARRAY_H
 
-#ifndef TARGET_LPC1768
-#error NeoArray only supports the NXP LPC1768
-#endif
+#include "NeoSink.h"
+#include "NeoLayout.h"
+#include "NeoDither.h"
+#include "NeoSprite.h"
+#include "NeoFont.h"
 
-// NeoColor struct definition to hold 24 bit
-// color data for each pixel, in GRB order
-typedef struct _NeoColor
-{
-    uint8_t green;
-    uint8_t red;
-    uint8_t blue;
-} NeoColor;
+#define NEO_GAMMA   2.2f    // default output gamma
+#define NEO_CANVAS  -1      // idx that draws on the whole canvas, see setLayout()
+
+/**
+ * Returns the 6 columns of the font.h glyph for a character, bit 0 of each
+ * column at the top. Characters outside the font give the blank glyph.
+ *
+ * @param c The character
+ */
+const uint8_t *neo_glyph(char c);
+
+/**
+ * Returns the font.h glyph for a character as row masks: byte r is row r up
+ * from the bottom and bit j of it is column j, so a glyph is clipped or shifted
+ * sideways a whole row at a time. The masks are built once, on the first call.
+ *
+ * @param c The character
+ */
+uint64_t neo_glyph_rows(char c);
 
 /**
  * NeoArr objects manage the buffering and assigning of
@@ -33,6 +46,7 @@ class NeoArr
 {
     public:
 
+#ifdef TARGET_LPC1768
         /**
          * Create a NeoArr object
          *
@@ -40,9 +54,21 @@ class NeoArr
          * @param N The number of arrays chained together.
          */
         NeoArr(PinName pin, int N);
+#endif
+
+        /**
+         * Create a NeoArr object that writes its frames to a sink
+         *
+         * @param sink The output stage that receives the pixel data on write()
+         * @param N The number of arrays chained together.
+         */
+        NeoArr(NeoSink *sink, int N);
+
+        ~NeoArr();
 
         /**
-         * Sets the brightness of the entire array. All functions using set pixel are affected by this value. 
+         * Sets the brightness of the entire array. The pixel buffer keeps the full colors
+         * and brightness is applied on write(), so this also affects pixels already drawn.
          * If a higher brightness is set, an external power supply may be necessary 
          *
          * The default brightness is 0.5
@@ -51,6 +77,90 @@ class NeoArr
          */
         void setBrightness(float bright);
 
+        /**
+         * Sets the gamma curve applied on write() so that color steps look even to the eye.
+         * Use 1.0 for a linear output.
+         *
+         * The default gamma is 2.2
+         *
+         * @param gamma The exponent of the output curve
+         */
+        void setGamma(float gamma);
+
+        /**
+         * Sets how the fractional output levels left by brightness and gamma are shown.
+         * Temporal dithering makes write() send the lit pixels every frame.
+         *
+         * The default is NEO_DITHER_OFF
+         *
+         * @param mode NEO_DITHER_OFF, or NEO_DITHER_TEMPORAL and/or NEO_DITHER_ORDERED
+         */
+        void setDither(int mode);
+
+        /**
+         * Sets how the boards are arranged and mounted. Board idx of the drawing
+         * functions is the board at grid position (idx % columns, idx / columns),
+         * and x and y follow the canvas rather than the board's own wiring.
+         *
+         * The default layout is all N boards in one row, chained left to right.
+         *
+         * Passing NEO_CANVAS as idx draws on the whole canvas instead of one board:
+         * x and y are then canvas co-ordinates, 0 to 8 times the boards across or up
+         * less one, and shapes are clipped at the edges of the canvas only, so lines
+         * and text run on from one board to the next.
+         *
+         * @param layout The layout; it may not use more than N boards
+         */
+        void setLayout(const NeoLayout &layout);
+
+        /**
+         * Returns the number of boards across the canvas of the layout
+         */
+        int columns() const { return tilesX; }
+
+        /**
+         * Returns the number of boards up the canvas of the layout
+         */
+        int rows() const { return height / 8; }
+
+        /**
+         * Turns indexed color mode on or off. In indexed mode each pixel holds one
+         * byte, an index into a 256 entry palette that is only looked up on write(),
+         * so the pixel buffer takes a third of the memory and changing the palette
+         * recolors the whole display at once.
+         *
+         * The drawing functions then take palette indices instead of colors: pass the
+         * index as the int color, or as blue with the red, green and blue arguments.
+         * Blended pixels take the new index when they are at least half covered, an
+         * INDEXED sprite without a palette is copied as indices, and dithering is not
+         * applied. Switching clears the pixels.
+         *
+         * The starting palette is a grey ramp (index i is 0x010101 * i).
+         *
+         * @param on true for indexed mode
+         */
+        void setIndexed(bool on);
+
+        /**
+         * Sets palette entries for indexed mode
+         *
+         * @param colors 24 bit colors using RGB hex indexing (e.g. 0xff0000 is red)
+         * @param first The first entry to set
+         * @param n The number of entries to set
+         */
+        void setPalette(const int *colors, int first = 0, int n = 256);
+
+        /**
+         * Rotates a range of palette entries by step places, so the color at entry i
+         * moves to entry i + step; colors pushed past last wrap round to first.
+         * Cycling colors this way animates every pixel for the cost of the palette.
+         *
+         * @param first The first entry of the range
+         * @param last The last entry of the range
+         * @param step Places to move each color, negative to move down
+         */
+        void rotatePalette(int first, int last, int step = 1);
+
         /**
          * Set a single pixel in the array to a specific color.
          *
@@ -155,6 +265,10 @@ class NeoArr
          /**
          * Draws a filled triangle of a specific color given three corner points
          *
+         * A pixel is filled when its centre is inside the triangle. Centres exactly on
+         * an edge go to only one of two triangles sharing that edge, so meshes of
+         * triangles cover every pixel once.
+         *
          * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
          * @param x1 The first x co-ordinate of a corner
          * @param y1 The first y co-ordinate of a corner
@@ -171,9 +285,189 @@ class NeoArr
          * Draws a filled triangle of a specific color given three corner points with reg, blue, and blue values in seperate arguments
          */
         void drawFilledTriangle(int idx, int x1, int y1, int x2, int y2, int x3, int y3, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws a circle outline of a specific color (midpoint algorithm)
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate of the centre
+         * @param y The y co-ordinate of the centre
+         * @param r The radius in pixels
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawCircle(int idx, int x, int y, int r, int color);
+
+        /**
+         * Draws a circle outline with red, green, and blue values in seperate arguments
+         */
+        void drawCircle(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws a filled circle of a specific color. It covers the same pixels as
+         * drawCircle and everything inside, filled one column at a time.
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate of the centre
+         * @param y The y co-ordinate of the centre
+         * @param r The radius in pixels
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawFilledCircle(int idx, int x, int y, int r, int color);
+
+        /**
+         * Draws a filled circle with red, green, and blue values in seperate arguments
+         */
+        void drawFilledCircle(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws an ellipse outline of a specific color with its axes along x and y
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate of the centre
+         * @param y The y co-ordinate of the centre
+         * @param rx The radius along x in pixels
+         * @param ry The radius along y in pixels
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawEllipse(int idx, int x, int y, int rx, int ry, int color);
+
+        /**
+         * Draws an ellipse outline with red, green, and blue values in seperate arguments
+         */
+        void drawEllipse(int idx, int x, int y, int rx, int ry, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws a filled ellipse of a specific color, covering the same pixels as
+         * drawEllipse and everything inside
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate of the centre
+         * @param y The y co-ordinate of the centre
+         * @param rx The radius along x in pixels
+         * @param ry The radius along y in pixels
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawFilledEllipse(int idx, int x, int y, int rx, int ry, int color);
+
+        /**
+         * Draws a filled ellipse with red, green, and blue values in seperate arguments
+         */
+        void drawFilledEllipse(int idx, int x, int y, int rx, int ry, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws the part of a circle outline between two angles. Angles are in degrees
+         * counter clockwise from the positive x axis, and the arc runs counter
+         * clockwise from start to end.
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate of the centre
+         * @param y The y co-ordinate of the centre
+         * @param r The radius in pixels
+         * @param start The angle the arc starts at
+         * @param end The angle the arc ends at; 360 or more past start draws the whole circle
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawArc(int idx, int x, int y, int r, int start, int end, int color);
+
+        /**
+         * Draws an arc with red, green, and blue values in seperate arguments
+         */
+        void drawArc(int idx, int x, int y, int r, int start, int end, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws a filled pie slice of a circle between two angles, as drawArc
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate of the centre
+         * @param y The y co-ordinate of the centre
+         * @param r The radius in pixels
+         * @param start The angle the slice starts at
+         * @param end The angle the slice ends at
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawFilledArc(int idx, int x, int y, int r, int start, int end, int color);
+
+        /**
+         * Draws a filled pie slice with red, green, and blue values in seperate arguments
+         */
+        void drawFilledArc(int idx, int x, int y, int r, int start, int end, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws an anti-aliased line between any two points (Wu's algorithm). Each step
+         * along the line splits the color between the two pixels nearest to it, and
+         * the color is blended into what is already on the board.
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x1 The first x co-ordinate of the line
+         * @param y1 The first y co-ordinate of the line
+         * @param x2 The second x co-ordinate of the line
+         * @param y2 The second y co-ordinate of the line
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawLineAA(int idx, int x1, int y1, int x2, int y2, int color);
+
+        /**
+         * Draws an anti-aliased line with red, green, and blue values in seperate arguments
+         */
+        void drawLineAA(int idx, int x1, int y1, int x2, int y2, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws an anti-aliased circle outline one pixel wide. Each pixel is blended by
+         * how far its centre is from the circle.
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate of the centre
+         * @param y The y co-ordinate of the centre
+         * @param r The radius in pixels, up to 254
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawCircleAA(int idx, int x, int y, int r, int color);
+
+        /**
+         * Draws an anti-aliased circle outline with red, green, and blue values in seperate arguments
+         */
+        void drawCircleAA(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws an anti-aliased filled circle. Pixels on the edge are blended by how
+         * much of them the disc covers.
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate of the centre
+         * @param y The y co-ordinate of the centre
+         * @param r The radius in pixels, up to 254
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawFilledCircleAA(int idx, int x, int y, int r, int color);
+
+        /**
+         * Draws an anti-aliased filled circle with red, green, and blue values in seperate arguments
+         */
+        void drawFilledCircleAA(int idx, int x, int y, int r, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Draws an anti-aliased filled triangle. Pixels on the edges are blended by how
+         * much of them the triangle covers.
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x1 The first x co-ordinate of a corner
+         * @param y1 The first y co-ordinate of a corner
+         * @param x2 The second x co-ordinate of a corner
+         * @param y2 The second y co-ordinate of a corner
+         * @param x3 The third x co-ordinate of a corner
+         * @param y3 The third y co-ordinate of a corner
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void drawFilledTriangleAA(int idx, int x1, int y1, int x2, int y2, int x3, int y3, int color);
+
+        /**
+         * Draws an anti-aliased filled triangle with red, green, and blue values in seperate arguments
+         */
+        void drawFilledTriangleAA(int idx, int x1, int y1, int x2, int y2, int x3, int y3, uint8_t red, uint8_t green, uint8_t blue);
         
         /**
-         * Draws a single 6x8 character on the array. The character will be pulled from font.h
+         * Draws a single 6x8 character on the array. The character will be pulled from font.h,
+         * which has ASCII only; drawText() with neo_font_plain draws UTF-8 text
          *
          * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
          * @param x The x co-ordinate of the lower left point of the character
@@ -188,15 +482,167 @@ class NeoArr
          */
         void drawChar(int idx, int x, int y, char c, uint8_t red, uint8_t green, uint8_t blue);
 
+        /**
+         * Draws a string in a proportional font, each character as wide as its glyph
+         * and kerned against the next, e.g. drawText(0, 0, 0, "Hi", neo_font_plain, 0xff0000)
+         *
+         * @param idx The index of the array to write on, or NEO_CANVAS
+         * @param x The x co-ordinate of the pen at the left of the first character
+         * @param y The y co-ordinate of the bottom row of the font
+         * @param text The string to draw, in UTF-8
+         * @param font The font, from tools/bdf2neo
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         * @returns The x co-ordinate of the pen after the last character
+         */
+        int drawText(int idx, int x, int y, const char *text, const NeoFont &font, int color);
+
+        /**
+         * Draws a string in a proportional font with red, green, and blue values in seperate arguments
+         */
+        int drawText(int idx, int x, int y, const char *text, const NeoFont &font, uint8_t red, uint8_t green, uint8_t blue);
+
       
         /**
          * Displays a 64 bit image on board idx
          *
          * @param idx The index of the board
-         * @param colors An array of length 64 containing the image to be displayed
+         * @param colors An array of length 64 containing the image to be displayed, column by column from the bottom up (colors[x*8 + y])
          */
         void showImage(int idx, const int *colors);
 
+        /**
+         * Copies a sprite onto a board. The sprite is clipped to the board once and
+         * each column goes in as one run; with no key and no alpha an RGB888 column
+         * is copied straight from the sprite's (possibly flash) data.
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate of the lower left corner of the sprite
+         * @param y The y co-ordinate of the lower left corner of the sprite
+         * @param sprite The sprite; see NeoSprite.h
+         * @param alpha How strongly the sprite covers the board, 255 replaces the pixels
+         */
+        void blit(int idx, int x, int y, const NeoSprite &sprite, uint8_t alpha = 255);
+
+        /**
+         * Copies part of a sprite onto a board
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0 (use 0 if there is only one array)
+         * @param x The x co-ordinate on the board of the lower left corner of the part
+         * @param y The y co-ordinate on the board of the lower left corner of the part
+         * @param sprite The sprite; see NeoSprite.h
+         * @param sx The first column of the sprite to copy
+         * @param sy The first row of the sprite to copy, 0 at the bottom
+         * @param w The number of columns to copy
+         * @param h The number of rows to copy
+         * @param alpha How strongly the sprite covers the board, 255 replaces the pixels
+         */
+        void blit(int idx, int x, int y, const NeoSprite &sprite, int sx, int sy, int w, int h, uint8_t alpha = 255);
+
+        /**
+         * Returns a pointer to column x of board idx. The 8 pixels y = 0 to 7 follow
+         * each other in memory, and the columns and boards after it follow in chain
+         * order; like the span functions it ignores the layout. Nothing is checked
+         * when writing through the pointer; the whole column is marked changed, so
+         * get the pointer again for each frame.
+         *
+         * @param idx The index of the array. Indexing starts at 0
+         * @param x The x co-ordinate of the column
+         * @returns The column, or NULL if it is not on the chain or the array is in indexed mode
+         */
+        NeoColor *column(int idx, int x);
+
+        /**
+         * Copies a run of pixels into the array starting at (x, y) and continuing up
+         * the column and on into the following columns and boards in chain order.
+         * The run is clipped to the chain once. It works in chain order and ignores
+         * the layout.
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0
+         * @param x The x co-ordinate of the first pixel
+         * @param y The y co-ordinate of the first pixel
+         * @param src The colors to copy, at full brightness
+         * @param n The number of pixels in src
+         */
+        void writeSpan(int idx, int x, int y, const NeoColor *src, int n);
+
+        /**
+         * Fills a run of n pixels with one color starting at (x, y), in the same order
+         * as writeSpan(). fillSpan(idx, x, 0, 8, color) fills a whole column. Like
+         * writeSpan() it works in chain order and ignores the layout.
+         *
+         * @param idx The index of the array to write on. Indexing starts at 0
+         * @param x The x co-ordinate of the first pixel
+         * @param y The y co-ordinate of the first pixel
+         * @param n The number of pixels to fill
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void fillSpan(int idx, int x, int y, int n, int color);
+
+        /**
+         * Fills a run of pixels with reg, blue, and blue values in seperate arguments
+         */
+        void fillSpan(int idx, int x, int y, int n, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Moves the whole canvas by (dx, dy) pixels across every board of the layout,
+         * e.g. scroll(-1, 0, 0) moves everything one pixel left. Pixels moved off the
+         * canvas are lost and the pixels left uncovered are filled with color, so a
+         * scrolling display only has to draw the newly uncovered column.
+         *
+         * @param dx Pixels to move right, negative to move left
+         * @param dy Pixels to move up, negative to move down
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void scroll(int dx, int dy, int color);
+
+        /**
+         * Scrolls the whole canvas and fills with reg, blue, and blue values in seperate arguments
+         */
+        void scroll(int dx, int dy, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Moves the pixels of a region of the canvas by (dx, dy), filling the part of
+         * the region left uncovered with color. Pixels outside the region are not
+         * touched. The canvas has (0, 0) at the bottom left of the layout and is
+         * 8 pixels wide and high for every board across and up.
+         *
+         * @param x The canvas x co-ordinate of the left of the region
+         * @param y The canvas y co-ordinate of the bottom of the region
+         * @param w The width of the region
+         * @param h The height of the region
+         * @param dx Pixels to move right, negative to move left
+         * @param dy Pixels to move up, negative to move down
+         * @param color Integer golding a 24 bit color using RGB hex indexing (e.g. 0xff0000 is red)
+         */
+        void scroll(int x, int y, int w, int h, int dx, int dy, int color);
+
+        /**
+         * Scrolls a region and fills with reg, blue, and blue values in seperate arguments
+         */
+        void scroll(int x, int y, int w, int h, int dx, int dy, uint8_t red, uint8_t green, uint8_t blue);
+
+        /**
+         * Moves the whole canvas by (dx, dy) pixels, wrapping the pixels that leave
+         * one edge around to the opposite edge
+         *
+         * @param dx Pixels to move right, negative to move left
+         * @param dy Pixels to move up, negative to move down
+         */
+        void rotate(int dx, int dy);
+
+        /**
+         * Moves the pixels of a region of the canvas by (dx, dy), wrapping them
+         * around within the region
+         *
+         * @param x The canvas x co-ordinate of the left of the region
+         * @param y The canvas y co-ordinate of the bottom of the region
+         * @param w The width of the region
+         * @param h The height of the region
+         * @param dx Pixels to move right, negative to move left
+         * @param dy Pixels to move up, negative to move down
+         */
+        void rotate(int x, int y, int w, int h, int dx, int dy);
+
         /**
          * Clears all pixels on all boards (sets them all to 0)
          */
@@ -206,19 +652,162 @@ class NeoArr
          * Write the colors out to the strip; this method must be called
          * to see any hardware effect.
          *
-         * This function disables interrupts while the strip data is being sent,
-         * each pixel takes approximately 30us to send, plus a 50us reset pulse
-         * at the end.
+         * The pixel data is handed to the sink. With the GPIO sink this function
+         * disables interrupts while the strip data is being sent, each pixel
+         * takes approximately 30us to send, plus a 50us reset pulse at the end.
+         *
+         * Only the pixels up to the last one changed since the previous write are
+         * sent, since the LEDs further down the chain keep their old colors. If
+         * nothing changed the frame is skipped.
          */
         void write();
 
+        /**
+         * Marks every pixel as changed so the next write() sends the whole chain,
+         * e.g. after the panels have been power cycled
+         */
+        void invalidate();
+
+        /**
+         * Turns double buffering on or off. Drawing always goes to a back buffer;
+         * write() brightness corrects it into the front buffer that the sink sends.
+         * When on, write() returns as soon as the sink has started sending, so an
+         * asynchronous sink such as NeoDmaSink streams the frame while the next one
+         * is drawn. The next write() waits for that frame to finish.
+         *
+         * When off (the default), write() does not return until the frame is out.
+         *
+         * @param on true to return from write() without waiting
+         */
+        void setDoubleBuffer(bool on);
+
+        /**
+         * Returns true while the last frame is still being sent
+         */
+        bool busy() const;
+
+        /**
+         * Attach a function to be called each time a frame has been sent.
+         * With a DMA sink it is called from interrupt context.
+         *
+         * @param fn The function to call, or NULL to detach
+         */
+        void attach(void (*fn)(void));
+
 
     protected:
-        NeoColor *arr;    // pixel data buffer modified by setPixel() and used by neo_out()
+        NeoColor *arr;    // pixel data buffer modified by setPixel(), full brightness
+        NeoColor *front;  // brightness corrected copy of arr passed to the sink
+        uint8_t *index;     // palette index of each pixel in indexed mode, in place of arr (NULL otherwise)
+        int *palette;       // 24 bit colors of the indices, NULL unless in indexed mode
+        int dirtyMax;       // highest pixel changed since the last write, -1 if the frame is unchanged
+        int litMax;         // highest pixel that may be non zero, -1 after clear()
+        bool stale;         // true if front does not match what the strip shows
+        bool async;         // true if write() returns while the sink is still sending
         int N;              // the number of pixels in the strip
         int Nbytes;         // the number of bytes of pixel data (always N*3)
         float bright;       // the master strip brightness
-        gpio_t gpio;        // gpio struct for initialization and getting register addresses
+        float gamma;        // exponent of the output curve
+        uint8_t lut[256];   // output value for each channel value, from bright and gamma
+        uint16_t lut16[256];    // the same in 8.8 fixed point for dithering
+        NeoDither *dither;  // dither stage, NULL when off
+        uint16_t *map;      // chain index of every canvas pixel, map[x*height + y]
+        uint8_t *strip;     // pixels rotate() wraps round, room for half the canvas
+        int width;          // canvas width in pixels
+        int height;         // canvas height in pixels
+        int tilesX;         // boards across the canvas
+        int tiles;          // boards in the layout
+        bool linear;        // map[i] == i, so the canvas runs along the chain column by column
+        int clipW;          // width of the board or canvas being drawn on, set by origin()
+        int clipH;          // height of the board or canvas being drawn on
+        int *extents;       // column half heights for the filled shapes, one per canvas column
+        NeoSink *sink;      // output stage used by write()
+        bool ownsSink;      // true if the sink was created by the constructor
+
+        void init(int N);
+        void buildLut();
+        bool clip(int &pixel, int &n) const;
+        void touch(int first, int last);
+        void fill(int pixel, int n, uint8_t red, uint8_t green, uint8_t blue);
+        bool origin(int idx, int &x, int &y);
+        void fillColumn(int x, int y0, int y1, uint8_t red, uint8_t green, uint8_t blue);
+        void fillExtents(int ox, int oy, int y, const int *ext, uint8_t red, uint8_t green, uint8_t blue);
+        void ellipse(int ox, int oy, int x, int y, int rx, int ry, int *ext, uint8_t red, uint8_t green, uint8_t blue);
+        bool clipRect(int &x, int &y, int &w, int &h) const;
+        void move(int x, int y, int w, int h, int dx, int dy);
+        void copyRect(int x, int y, int w, int h, uint8_t *buf, bool save);
+
+        // stores a color (or in indexed mode the index in blue) at a chain index and marks it changed
+        void put(int pixel, uint8_t red, uint8_t green, uint8_t blue)
+        {
+            if (index)
+            {
+                if (index[pixel] == blue)
+                    return;
+                index[pixel] = blue;
+            }
+            else
+            {
+                NeoColor &p = arr[pixel];
+                if (p.red == red && p.green == green && p.blue == blue)
+                    return;     // unchanged pixels do not extend the frame
+                p.red = red;
+                p.green = green;
+                p.blue = blue;
+            }
+            if (pixel > dirtyMax)
+                dirtyMax = pixel;
+            if (pixel > litMax)
+                litMax = pixel;
+        }
+
+        // mixes two channel values, alpha 0 keeps from and 255 gives to
+        static uint8_t mix(uint8_t from, uint8_t to, int alpha)
+        {
+            int v = from * (255 - alpha) + to * alpha + 128;
+            return (v + (v >> 8)) >> 8;     // exact division by 255
+        }
+
+        // blends a color over a chain index with alpha 0 to 255
+        void blend(int pixel, uint8_t red, uint8_t green, uint8_t blue, int alpha)
+        {
+            if (index)
+            {
+                if (alpha >= 128)   // indices do not mix
+                    put(pixel, red, green, blue);
+                return;
+            }
+            const NeoColor &p = arr[pixel];
+            put(pixel, mix(p.red, red, alpha), mix(p.green, green, alpha), mix(p.blue, blue, alpha));
+        }
+
+        // blends a color over pixel (x, y) of the board or canvas at canvas corner (ox, oy)
+        void shade(int ox, int oy, int x, int y, uint8_t red, uint8_t green, uint8_t blue, int alpha)
+        {
+            if ((unsigned)x >= (unsigned)clipW || (unsigned)y >= (unsigned)clipH || alpha <= 0)
+                return;
+            blend(map[(ox + x)*height + oy + y], red, green, blue, alpha);
+        }
+
+        // sets pixel (x, y) of the board or canvas at canvas corner (ox, oy), ignoring points off it
+        void dot(int ox, int oy, int x, int y, uint8_t red, uint8_t green, uint8_t blue)
+        {
+            if ((unsigned)x < (unsigned)clipW && (unsigned)y < (unsigned)clipH)
+                put(map[(ox + x)*height + oy + y], red, green, blue);
+        }
+
+        // sets a canvas pixel, ignoring points off the canvas
+        void plot(int x, int y, uint8_t red, uint8_t green, uint8_t blue)
+        {
+            if ((unsigned)x < (unsigned)width && (unsigned)y < (unsigned)height)
+                put(map[x*height + y], red, green, blue);
+        }
+        int render(int n);
+
+    private:
+        // not copyable: a copy would free the buffers, the layout table and an owned sink a second time
+        NeoArr(const NeoArr&);
+        NeoArr &operator=(const NeoArr&);
 };
 
 #endif
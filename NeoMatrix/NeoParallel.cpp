@@ -0,0 +1,167 @@
+/**********************************************
+ * NeoParallel.cpp
+ *
+ *  Parallel output of up to 8 NeoPixel chains on one GPIO port. Bit timing comes
+ *  from the DWT cycle counter, so it follows SystemCoreClock instead of depending
+ *  on counted NOPs.
+ */
+
+#include "NeoParallel.h"
+#include "NeoProfile.h"
+
+
+void neo_transpose8(const uint8_t *in, uint8_t *out)
+{
+    // rows are loaded with lane 7 on top so that lane k ends up in bit k
+    uint32_t x = (in[7] << 24) | (in[6] << 16) | (in[5] << 8) | in[4];
+    uint32_t y = (in[3] << 24) | (in[2] << 16) | (in[1] << 8) | in[0];
+    uint32_t t;
+
+    // swap 1x1, 2x2 and then 4x4 blocks across the diagonal
+    t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    out[0] = x >> 24;
+    out[1] = x >> 16;
+    out[2] = x >> 8;
+    out[3] = x;
+    out[4] = y >> 24;
+    out[5] = y >> 16;
+    out[6] = y >> 8;
+    out[7] = y;
+}
+
+
+void NeoParallel::Lane::write(const NeoColor *px, int n)
+{
+    this->px = (const uint8_t*)px;
+    if (n > this->n)
+        this->n = n;
+    if (n > size)
+        size = n;       // NeoArr sends its whole chain on the first write
+}
+
+NeoParallel::NeoParallel(int lanes)
+{
+    count = (lanes > NEO_MAX_LANES) ? NEO_MAX_LANES : lanes;
+}
+
+NeoSink *NeoParallel::lane(int i)
+{
+    if (i < 0 || i >= count)
+        return NULL;
+    return &lanes[i];
+}
+
+int NeoParallel::length() const
+{
+    int n = 0;
+    for (int i = 0; i < count; i++)
+        if (lanes[i].n > n)
+            n = lanes[i].n;
+    return n * 3;
+}
+
+void NeoParallel::transpose(int byte, uint8_t *out) const
+{
+    uint8_t in[NEO_MAX_LANES];
+    for (int i = 0; i < NEO_MAX_LANES; i++)
+        in[i] = (i < count && byte < lanes[i].size * 3) ? lanes[i].px[byte] : 0;
+    neo_transpose8(in, out);
+}
+
+
+#ifdef TARGET_LPC1768
+
+NeoParallel::NeoParallel(const PinName *pins, int lanes)
+{
+    count = (lanes > NEO_MAX_LANES) ? NEO_MAX_LANES : lanes;
+    port = (LPC_GPIO_TypeDef*)((uint32_t)pins[0] & ~0x1F);
+
+    uint32_t mask[NEO_MAX_LANES];
+    all = 0;
+    for (int i = 0; i < count; i++)
+    {
+        gpio_t gpio;
+        gpio_init(&gpio, pins[i], PIN_OUTPUT);
+        mask[i] = 1 << ((int)pins[i] & 0x1F);
+        all |= mask[i];
+    }
+    port->FIOCLR = all;
+
+    for (int m = 0; m < 256; m++)
+    {
+        spread[m] = 0;
+        for (int i = 0; i < count; i++)
+            if (m & (1 << i))
+                spread[m] |= mask[i];
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;     // start the cycle counter
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void NeoParallel::write()
+{
+    int len = length();
+    if (len == 0)
+        return;
+
+    // WS2812 timing in core cycles
+    uint32_t mhz = SystemCoreClock / 1000000;
+    uint32_t t0h = mhz * 350 / 1000;
+    uint32_t t1h = mhz * 800 / 1000;
+    uint32_t period = mhz * 1250 / 1000;
+
+    uint8_t bits[8];
+    uint32_t zeros[8];
+
+    neo_profile_irq.start();
+    __disable_irq();
+    uint32_t start = DWT->CYCCNT;
+    for (int byte = 0; byte < len; byte++)
+    {
+        // note: the next byte is transposed while the last bit of the previous one is
+        // low, which stretches that low time from 450ns to about 1.5us (the transpose
+        // and 8 table lookups take around 100 cycles at 96MHz). A WS2812 times only
+        // the high pulse of each bit and does not latch until the line has been low
+        // for 50us (about 6us on real parts), so the longer gap between bytes is
+        // read as an ordinary low and the frame carries on.
+        transpose(byte, bits);
+        for (int b = 0; b < 8; b++)
+            zeros[b] = all & ~spread[bits[b]];
+
+        for (int b = 0; b < 8; b++)
+        {
+            while (DWT->CYCCNT - start < period);
+            start = DWT->CYCCNT;
+            port->FIOSET = all;             // every lane starts its bit
+            while (DWT->CYCCNT - start < t0h);
+            port->FIOCLR = zeros[b];        // lanes sending a zero drop early
+            while (DWT->CYCCNT - start < t1h);
+            port->FIOCLR = all;
+        }
+    }
+    __enable_irq();
+    neo_profile_irq.stop();
+    wait_us(50);            // wait 50us for the reset pulse
+
+    for (int i = 0; i < count; i++)
+        lanes[i].sent();
+}
+
+#else
+
+void NeoParallel::write()
+{
+    // no port on a host build; the frame is just marked as sent
+    for (int i = 0; i < count; i++)
+        lanes[i].sent();
+}
+
+#endif
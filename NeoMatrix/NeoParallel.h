@@ -0,0 +1,103 @@
+/**
+ * NeoParallel.h
+ *
+ * Drives up to 8 chains at once from pins on the same GPIO port. For every byte
+ * position the lanes' bytes are bit transposed into 8 lane masks, and each LED bit
+ * of all chains goes out with a single FIOSET/FIOCLR store, so 8 chains take the
+ * time of one.
+ *
+ * Each chain is its own NeoArr writing to lane(i); NeoArr::write() only records
+ * the frame and NeoParallel::write() sends all lanes together.
+ *
+ */
+
+#ifndef NEOPARALLEL_H
+#define NEOPARALLEL_H
+
+#include "NeoSink.h"
+
+#define NEO_MAX_LANES   8
+
+/**
+ * Transposes an 8x8 bit block. Bit k of out[j] is bit (7 - j) of in[k], so out[0]
+ * holds the most significant bit of every lane.
+ *
+ * @param in One byte per lane
+ * @param out One lane mask per bit, most significant bit first
+ */
+void neo_transpose8(const uint8_t *in, uint8_t *out);
+
+/**
+ * Parallel output for up to 8 chains
+ */
+class NeoParallel
+{
+    public:
+#ifdef TARGET_LPC1768
+        /**
+         * Create a NeoParallel driving the strips on the given pins
+         *
+         * @param pins The data pins, one per lane; all must be on the same GPIO port
+         * @param lanes The number of pins, up to 8
+         */
+        NeoParallel(const PinName *pins, int lanes);
+#endif
+
+        /**
+         * Create a NeoParallel without any pins, for transposing on a host build
+         *
+         * @param lanes The number of lanes, up to 8
+         */
+        NeoParallel(int lanes);
+
+        /**
+         * Returns the sink to pass to the NeoArr of lane i
+         */
+        NeoSink *lane(int i);
+
+        /**
+         * Sends the latest frame of every lane. Lanes that did not change are
+         * resent where another lane's frame is longer.
+         */
+        void write();
+
+        /**
+         * Returns the number of data bytes per lane that write() will send
+         */
+        int length() const;
+
+        /**
+         * Transposes one byte position of all lanes
+         *
+         * @param byte The byte position in the frame, 0 to length()-1
+         * @param out Receives 8 lane masks, most significant bit first
+         */
+        void transpose(int byte, uint8_t *out) const;
+
+    protected:
+        /**
+         * Records the frame of one chain for NeoParallel
+         */
+        class Lane : public NeoSink
+        {
+            public:
+                Lane() : px(NULL), n(0), size(0) {}
+                virtual void write(const NeoColor *px, int n);
+
+                const uint8_t *px;      // last frame of this chain
+                int n;                  // pixels that changed in the last frame
+                int size;               // pixels in this chain
+                void sent() { n = 0; complete(); }
+        };
+
+        Lane lanes[NEO_MAX_LANES];
+        int count;                      // lanes in use
+
+#ifdef TARGET_LPC1768
+        LPC_GPIO_TypeDef *port;         // port the pins are on
+        uint32_t all;                   // mask of every lane pin
+        uint32_t spread[256];           // port mask for each lane mask
+#endif
+};
+
+#endif
@@ -0,0 +1,158 @@
+/**********************************************
+ * NeoProfile.cpp
+ *
+ *  Per scope timing statistics. On the LPC1768 the DWT cycle counter is started
+ *  the first time a profile is created; it wraps every 44 seconds at 96MHz, which
+ *  is far longer than any scope worth timing.
+ */
+
+#include "NeoProfile.h"
+#include <string.h>
+
+#ifndef TARGET_LPC1768
+#include <chrono>
+#endif
+
+NeoProfile *NeoProfile::first = NULL;
+
+NeoProfile neo_profile_capture("capture");
+NeoProfile neo_profile_analysis("analysis");
+NeoProfile neo_profile_render("render");
+NeoProfile neo_profile_write("write");
+NeoProfile neo_profile_irq("irq off");
+
+
+#ifdef TARGET_LPC1768
+
+uint32_t neo_ticks()
+{
+    return DWT->CYCCNT;
+}
+
+uint32_t neo_ticks_per_us()
+{
+    return SystemCoreClock / 1000000;
+}
+
+static void neo_ticks_init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+#else
+
+static std::chrono::steady_clock::time_point neo_epoch = std::chrono::steady_clock::now();
+
+uint32_t neo_ticks()
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - neo_epoch).count();
+}
+
+uint32_t neo_ticks_per_us()
+{
+    return 1000;
+}
+
+static void neo_ticks_init()
+{
+}
+
+#endif
+
+
+NeoProfile::NeoProfile(const char *name) : name(name)
+{
+    neo_ticks_init();
+    reset();
+    next = first;
+    first = this;
+}
+
+NeoProfile::~NeoProfile()
+{
+    for (NeoProfile **p = &first; *p; p = &(*p)->next)
+    {
+        if (*p == this)
+        {
+            *p = next;
+            break;
+        }
+    }
+}
+
+void NeoProfile::add(uint32_t ticks)
+{
+    if (n == 0 || ticks < lo)
+        lo = ticks;
+    if (ticks > hi)
+        hi = ticks;
+    total += ticks;
+    n++;
+
+    int b = 0;      // position of the top bit picks the bin
+    while ((ticks >> 1) && b < NEO_PROFILE_BINS - 1)
+    {
+        ticks >>= 1;
+        b++;
+    }
+    hist[b]++;
+}
+
+void NeoProfile::reset()
+{
+    n = 0;
+    lo = 0;
+    hi = 0;
+    total = 0;
+    memset(hist, 0, sizeof(hist));
+}
+
+int NeoProfile::format(char *buf, int size) const
+{
+    float us = (float)neo_ticks_per_us();
+    int len = snprintf(buf, size, "%-10s n=%lu min=%.2fus mean=%.2fus max=%.2fus |",
+                       name, (unsigned long)n, min() / us, mean() / us, max() / us);
+
+    // histogram from the first to the last non empty bin
+    int b0 = 0, b1 = NEO_PROFILE_BINS - 1;
+    while (b0 < b1 && hist[b0] == 0)
+        b0++;
+    while (b1 > b0 && hist[b1] == 0)
+        b1--;
+    for (int b = b0; b <= b1 && len < size; b++)
+        len += snprintf(buf + len, size - len, " %.1fus:%lu", (1UL << b) / us, (unsigned long)hist[b]);
+    return len;
+}
+
+void NeoProfile::dump(FILE *out) const
+{
+    char buf[512];
+    format(buf, sizeof(buf));
+    fprintf(out, "%s\n", buf);
+}
+
+void NeoProfile::dumpAll(FILE *out)
+{
+    for (NeoProfile *p = first; p; p = p->next)
+        p->dump(out);
+}
+
+#ifdef TARGET_LPC1768
+void NeoProfile::dumpAll(Stream &out)
+{
+    char buf[512];
+    for (NeoProfile *p = first; p; p = p->next)
+    {
+        p->format(buf, sizeof(buf));
+        out.printf("%s\r\n", buf);
+    }
+}
+#endif
+
+void NeoProfile::resetAll()
+{
+    for (NeoProfile *p = first; p; p = p->next)
+        p->reset();
+}
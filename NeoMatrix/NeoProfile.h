@@ -0,0 +1,132 @@
+/**
+ * NeoProfile.h
+ *
+ * Cycle counting for finding where the frame time goes. Each NeoProfile is a
+ * named scope that keeps the minimum, maximum, mean and a power of two histogram
+ * of its run times. On the LPC1768 the times come from the DWT cycle counter;
+ * host builds use std::chrono and count nanoseconds instead.
+ *
+ */
+
+#ifndef NEOPROFILE_H
+#define NEOPROFILE_H
+
+#include "NeoSink.h"
+#include <stdio.h>
+
+#define NEO_PROFILE_BINS    24      // histogram bin i counts times from 2^i to 2^(i+1)-1 ticks
+
+/**
+ * Returns the free running tick counter, core cycles on the LPC1768 and
+ * nanoseconds on a host build
+ */
+uint32_t neo_ticks();
+
+/**
+ * Returns the number of ticks in one microsecond
+ */
+uint32_t neo_ticks_per_us();
+
+/**
+ * Statistics for one named scope
+ */
+class NeoProfile
+{
+    public:
+        /**
+         * Create a NeoProfile. It is added to the list printed by dumpAll().
+         *
+         * @param name The name printed for this scope
+         */
+        NeoProfile(const char *name);
+        ~NeoProfile();
+
+        /**
+         * Starts timing a run of this scope
+         */
+        void start() { begin = neo_ticks(); }
+
+        /**
+         * Ends the run started by start() and adds it to the statistics
+         */
+        void stop() { add(neo_ticks() - begin); }
+
+        /**
+         * Adds a run of the given length
+         *
+         * @param ticks The length of the run in ticks
+         */
+        void add(uint32_t ticks);
+
+        /**
+         * Clears the statistics
+         */
+        void reset();
+
+        uint32_t count() const { return n; }
+        uint32_t min() const { return n ? lo : 0; }
+        uint32_t max() const { return hi; }
+        uint32_t mean() const { return n ? (uint32_t)(total / n) : 0; }
+        uint32_t bin(int i) const { return hist[i]; }
+        const char *label() const { return name; }
+
+        /**
+         * Prints the statistics of this scope on one line, times in microseconds
+         */
+        void dump(FILE *out = stdout) const;
+
+        /**
+         * Prints every NeoProfile
+         */
+        static void dumpAll(FILE *out = stdout);
+
+#ifdef TARGET_LPC1768
+        /**
+         * Prints every NeoProfile over a serial port
+         *
+         * @param out The port, e.g. Serial pc(USBTX, USBRX)
+         */
+        static void dumpAll(Stream &out);
+#endif
+
+        /**
+         * Clears the statistics of every NeoProfile
+         */
+        static void resetAll();
+
+    protected:
+        const char *name;               // printed name
+        uint32_t begin;                 // tick count at start()
+        uint32_t n;                     // number of runs
+        uint32_t lo;                    // shortest run
+        uint32_t hi;                    // longest run
+        uint64_t total;                 // sum of all runs
+        uint32_t hist[NEO_PROFILE_BINS];
+        NeoProfile *next;               // list of all profiles
+
+        static NeoProfile *first;
+
+        int format(char *buf, int size) const;
+};
+
+/**
+ * Times the enclosing block, e.g. { NeoProfileScope s(neo_profile_render); ... }
+ */
+class NeoProfileScope
+{
+    public:
+        NeoProfileScope(NeoProfile &profile) : profile(profile) { profile.start(); }
+        ~NeoProfileScope() { profile.stop(); }
+
+    protected:
+        NeoProfile &profile;
+};
+
+// the standard scopes; the library times write and irq, the application the rest
+extern NeoProfile neo_profile_capture;      // audio sampling
+extern NeoProfile neo_profile_analysis;     // turning samples into levels
+extern NeoProfile neo_profile_render;       // drawing the frame
+extern NeoProfile neo_profile_write;        // NeoArr::write()
+extern NeoProfile neo_profile_irq;          // time spent with interrupts disabled for output
+
+#endif
@@ -0,0 +1,130 @@
+/**********************************************
+ * NeoSink.cpp
+ *
+ *  Output stages for NeoArr. The GPIO sink is the original LPC1768 output path;
+ *  the null, memory and PPM sinks also build on a host machine so the drawing
+ *  code can be profiled and checked away from the board.
+ */
+
+#include "NeoSink.h"
+#include "NeoProfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+NeoMemorySink::NeoMemorySink(int n) : size(n), len(0), count(0)
+{
+    buf = (NeoColor*)malloc(n * sizeof(NeoColor));
+    if (buf == NULL)
+    {
+        printf("NeoMemorySink: ERROR unable to malloc pixel array data");
+        size = 0;
+    }
+}
+
+NeoMemorySink::~NeoMemorySink()
+{
+    free(buf);
+}
+
+void NeoMemorySink::write(const NeoColor *px, int n)
+{
+    if (n > size)
+        n = size;
+    memcpy(buf, px, n * sizeof(NeoColor));
+    if (n > len)
+        len = n;    // like the strip, pixels past a short frame keep their colors
+    count++;
+    complete();
+}
+
+int NeoMemorySink::pixel(int i) const
+{
+    if (i < 0 || i >= len)
+        return 0;
+    return (buf[i].red << 16) | (buf[i].green << 8) | buf[i].blue;
+}
+
+
+NeoPpmSink::NeoPpmSink(const char *pattern, int N, int scale) :
+    pattern(pattern), N(N), scale(scale), count(0)
+{
+    frame = (NeoColor*)calloc(N * 64, sizeof(NeoColor));    // the strip starts dark
+    if (frame == NULL)
+    {
+        printf("NeoPpmSink: ERROR unable to malloc frame data");
+        this->N = 0;
+    }
+}
+
+NeoPpmSink::~NeoPpmSink()
+{
+    free(frame);
+}
+
+void NeoPpmSink::write(const NeoColor *px, int n)
+{
+    if (n > N * 64)
+        n = N * 64;
+    memcpy(frame, px, n * sizeof(NeoColor));
+
+    char name[128];
+    snprintf(name, sizeof(name), pattern, count++);
+
+    FILE *fp = fopen(name, "wb");
+    if (fp == NULL)
+    {
+        printf("NeoPpmSink: ERROR unable to open %s\n", name);
+        return;
+    }
+
+    int width = N * 8 * scale;
+    int height = 8 * scale;
+    fprintf(fp, "P6\n%d %d\n255\n", width, height);
+
+    for (int row = 0; row < height; row++)
+    {
+        int y = 7 - row / scale;    // image rows run top down, array rows bottom up
+        for (int col = 0; col < width; col++)
+        {
+            int x = col / scale;
+            const NeoColor &p = frame[(x / 8) * 64 + (x % 8) * 8 + y];
+            uint8_t rgb[3] = {p.red, p.green, p.blue};
+            fwrite(rgb, 1, 3, fp);
+        }
+    }
+    fclose(fp);
+    complete();
+}
+
+
+#ifdef TARGET_LPC1768
+
+// FastIO register address and bitmask for the GPIO pin
+// because these are imported in the assembly
+uint32_t neo_fio_reg;
+uint32_t neo_bitmask;
+
+// function to write to the strip, implemented in ARM assembly
+extern "C" void neo_out(const NeoColor*, int);
+
+NeoGpioSink::NeoGpioSink(PinName pin)
+{
+    gpio_init(&gpio, pin, PIN_OUTPUT);      // initialize GPIO registers
+    neo_fio_reg = (uint32_t)gpio.reg_dir;   // set registers and bitmask for
+    neo_bitmask = 1 << ((int)pin & 0x1F);   // the assembly to use
+}
+
+void NeoGpioSink::write(const NeoColor *px, int n)
+{
+    neo_profile_irq.start();
+    __disable_irq();        // disable interrupts
+    neo_out(px, n * 3);     // output to the strip
+    __enable_irq();         // enable interrupts
+    neo_profile_irq.stop();
+    wait_us(50);            // wait 50us for the reset pulse
+    complete();
+}
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * NeoSink.h
+ *
+ * Output stage for NeoArr. A sink receives the finished pixel buffer in chain
+ * order every time NeoArr::write() is called. The LPC1768 GPIO sink drives the
+ * strip through NeoCore.s; the remaining sinks let the library run on a host
+ * machine for profiling and inspection.
+ *
+ */
+
+#ifndef NEOSINK_H
+#define NEOSINK_H
+
+#ifdef TARGET_LPC1768
+#include "mbed.h"
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+// NeoColor struct definition to hold 24 bit
+// color data for each pixel, in GRB order
+typedef struct _NeoColor
+{
+    uint8_t green;
+    uint8_t red;
+    uint8_t blue;
+} NeoColor;
+
+/**
+ * Abstract pixel sink used by NeoArr::write()
+ */
+class NeoSink
+{
+    public:
+        NeoSink() : done(NULL) {}
+        virtual ~NeoSink() {}
+
+        /**
+         * Send a frame of pixels to the output. An asynchronous sink may return
+         * before the frame has gone out, in which case px must stay untouched
+         * until busy() returns false.
+         *
+         * @param px The pixel data in chain order
+         * @param n The number of pixels in px
+         */
+        virtual void write(const NeoColor *px, int n) = 0;
+
+        /**
+         * Returns true while a frame is still being sent
+         */
+        virtual bool busy() const { return false; }
+
+        /**
+         * Attach a function to be called each time a frame has been sent.
+         * For DMA sinks it is called from interrupt context.
+         *
+         * @param fn The function to call, or NULL to detach
+         */
+        void attach(void (*fn)(void)) { done = fn; }
+
+    protected:
+        void (*done)(void);     // completion callback set by attach()
+
+        // called by the sink once a frame has been sent
+        void complete() { if (done) done(); }
+};
+
+/**
+ * Sink that discards every frame; used to time the drawing code on its own
+ */
+class NeoNullSink : public NeoSink
+{
+    public:
+        virtual void write(const NeoColor *, int) { complete(); }
+};
+
+/**
+ * Sink that keeps a copy of what the strip would show. Like the LEDs, pixels
+ * past the end of a short frame keep the colors they were last sent.
+ */
+class NeoMemorySink : public NeoSink
+{
+    public:
+        /**
+         * Create a NeoMemorySink
+         *
+         * @param n The largest number of pixels that will be recorded
+         */
+        NeoMemorySink(int n);
+        virtual ~NeoMemorySink();
+
+        virtual void write(const NeoColor *px, int n);
+
+        /**
+         * Returns the recorded color of pixel i as 0xRRGGBB
+         */
+        int pixel(int i) const;
+
+        const NeoColor *data() const { return buf; }
+        int length() const { return len; }      // pixels sent so far
+        int frames() const { return count; }    // number of frames written
+
+    protected:
+        NeoColor *buf;      // copy of the last frame
+        int size;           // capacity of buf in pixels
+        int len;            // number of pixels sent so far
+        int count;          // number of write() calls
+};
+
+/**
+ * Sink that dumps every frame to a binary PPM image. Panels are laid side by
+ * side in chain order, with y = 0 on the bottom row of the image. Like the
+ * strip, pixels past the end of a short write keep their last colors.
+ */
+class NeoPpmSink : public NeoSink
+{
+    public:
+        /**
+         * Create a NeoPpmSink
+         *
+         * @param pattern printf style file name taking the frame number, e.g. "frame%04d.ppm"
+         * @param N The number of arrays chained together
+         * @param scale The number of image pixels drawn for each LED
+         */
+        NeoPpmSink(const char *pattern, int N, int scale = 8);
+        virtual ~NeoPpmSink();
+
+        virtual void write(const NeoColor *px, int n);
+
+        int frames() const { return count; }
+
+    protected:
+        const char *pattern;    // file name pattern
+        int N;                  // the number of arrays in the image
+        int scale;              // image pixels per LED
+        int count;              // number of frames written
+        NeoColor *frame;        // what the strip shows, N*64 pixels; a short write only changes its start
+};
+
+#ifdef TARGET_LPC1768
+/**
+ * Sink that bit-bangs the strip on a single GPIO pin using neo_out()
+ */
+class NeoGpioSink : public NeoSink
+{
+    public:
+        /**
+         * Create a NeoGpioSink
+         *
+         * @param pin The mbed data pin name
+         */
+        NeoGpioSink(PinName pin);
+
+        /**
+         * This function disables interrupts while the strip data is being sent,
+         * each pixel takes approximately 30us to send, plus a 50us reset pulse
+         * at the end.
+         */
+        virtual void write(const NeoColor *px, int n);
+
+    protected:
+        gpio_t gpio;        // gpio struct for initialization and getting register addresses
+};
+#endif
+
+#endif
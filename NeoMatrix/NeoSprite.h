@@ -0,0 +1,45 @@
+/**
+ * NeoSprite.h
+ *
+ * Describes a bitmap for NeoArr::blit(). A NeoSprite only points at its pixels,
+ * so a const sprite and its const pixel array stay in flash and are blitted
+ * straight from there.
+ *
+ * Pixels are stored column by column, each column from the bottom up, which is
+ * the order the chain runs on a board, e.g.
+ *
+ *     static const uint16_t heartPixels[64] = { ... };
+ *     static const NeoSprite heart = { heartPixels, NULL, 8, 8, NEO_SPRITE_RGB565, NEO_SPRITE_KEY, 0 };
+ *
+ */
+
+#ifndef NEOSPRITE_H
+#define NEOSPRITE_H
+
+#include "NeoSink.h"
+
+// pixel formats of a NeoSprite
+#define NEO_SPRITE_RGB888   0   // one NeoColor per pixel
+#define NEO_SPRITE_RGB565   1   // one uint16_t per pixel, red in the top 5 bits
+#define NEO_SPRITE_MONO     2   // one bit per pixel through palette[0] and palette[1]; each column takes whole bytes, bit 0 of the first byte at the bottom
+#define NEO_SPRITE_INDEXED  3   // one byte per pixel through palette
+#define NEO_SPRITE_COLOR    4   // one int per pixel, 24 bit colors as taken by setPixel (e.g. 0xff0000 is red)
+
+// sprite flags
+#define NEO_SPRITE_KEY      1   // pixels whose stored value equals key are not drawn
+
+/**
+ * A bitmap in one of the NEO_SPRITE formats
+ */
+typedef struct _NeoSprite
+{
+    const void *data;           // pixels, column by column from the bottom up
+    const int *palette;         // 24 bit colors for MONO and INDEXED; white on black if NULL
+    uint16_t width;             // columns
+    uint16_t height;            // rows
+    uint8_t format;             // one of the NEO_SPRITE formats
+    uint8_t flags;              // NEO_SPRITE flags
+    uint32_t key;               // stored value (color, 565 value or index) that is transparent
+} NeoSprite;
+
+#endif
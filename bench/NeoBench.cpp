@@ -0,0 +1,340 @@
+/**********************************************
+ * NeoBench.cpp
+ *
+ *  Host benchmark for the NeoArr drawing primitives. Every primitive is called
+ *  millions of times against a NeoNullSink and the average cost per call is
+ *  printed, so regressions in the render path show up before flashing the board.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix bench/NeoBench.cpp NeoMatrix/Neo*.cpp -o neobench
+ *      ./neobench [scale]
+ *
+ *  scale multiplies the number of calls made for each primitive (default 1).
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "NeoMatrix.h"
+#include "NeoDma.h"
+#include "NeoParallel.h"
+#include "NeoCompositor.h"
+#include "NeoList.h"
+#include "NeoMarquee.h"
+#include "NeoProfile.h"
+
+#define PANELS  4
+
+static NeoNullSink sink;
+static NeoArr array(&sink, PANELS);
+
+static NeoSimDmaEngine dma(64);
+static NeoDmaSink dmaSink(&dma, PANELS * 64);
+static NeoArr dmaArray(&dmaSink, PANELS);
+
+static NeoNullSink ditherSink;
+static NeoArr ditherArray(&ditherSink, PANELS);
+
+// drawFilledTriangle as it was before the edge walk: the two legs through the second
+// corner, then a line to that corner from every step along the third leg
+class LineFanArr : public NeoArr
+{
+    public:
+        LineFanArr(NeoSink *sink, int N) : NeoArr(sink, N) {}
+        void drawFilledTriangleLineFan(int idx, int x1, int y1, int x2, int y2, int x3, int y3, uint8_t red, uint8_t green, uint8_t blue)
+        {
+            drawLine(idx, x1, y1, x2, y2, red, green, blue);
+            drawLine(idx, x2, y2, x3, y3, red, green, blue);
+
+            float k;
+            int j = rint(sqrt(pow((x1-x3),2.0) + pow((y1-y3),2.0)));
+            if(x1 != x3)
+                k = atan2( (float)(y3-y1),(float) ( x3-x1));
+            else
+                k = acos(0.0);
+
+            for(float n=0; n<=j; n++)
+                if((x1+ rint(n*cos(k))) >=0 && (x1+rint( n*cos(k))) <=7 &&  (y1+rint(n*sin(k)))>=0 &&  (y1+rint(n*sin(k)))<=7)
+                    drawLine(idx, x1+ rint(n*cos(k)), y1+ rint(n*sin(k)), x2, y2, red, green, blue);
+        }
+};
+
+static NeoNullSink lineFanSink;
+static LineFanArr lineFanArray(&lineFanSink, PANELS);
+
+static NeoNullSink indexedSink;
+static NeoArr indexedArray(&indexedSink, PANELS);
+
+static NeoNullSink compositeSink;
+static NeoArr compositeArray(&compositeSink, PANELS);
+static NeoCompositor compositor(&compositeArray, PANELS, 3);
+
+static NeoList scene(PANELS);
+static NeoList cachedScene(PANELS);
+
+static NeoMarquee marquee(&array, 0, 0, PANELS * 8);
+static NeoMarquee smoothMarquee(&array, 0, 0, PANELS * 8);
+
+// drawChar as it was before neo_glyph_rows(): a bit test and a clipped dot() for each of the 48 pixels
+class PerBitArr : public NeoArr
+{
+    public:
+        PerBitArr(NeoSink *sink, int N) : NeoArr(sink, N) {}
+        void drawCharPerBit(int idx, int x, int y, char c, uint8_t red, uint8_t green, uint8_t blue)
+        {
+            int ox, oy;
+            if (!origin(idx, ox, oy))
+                return;
+            const uint8_t *chr = neo_glyph(c);
+            for (int j = 0; j < 6; j++)
+                for (int i = 0; i < 8; i++)
+                    if (chr[j] & (1<<i))
+                        dot(ox, oy, x+j, y+7-i, red, green, blue);
+        }
+};
+
+static NeoNullSink perBitSink;
+static PerBitArr perBitArray(&perBitSink, PANELS);
+
+static NeoParallel parallel(NEO_MAX_LANES);
+static NeoArr *laneArray[NEO_MAX_LANES];
+static uint8_t laneBits[8];
+
+static int image[64];
+static NeoColor run[64];
+static uint16_t sprite565[64];
+static const NeoSprite sprite888 = {run, NULL, 8, 8, NEO_SPRITE_RGB888, 0, 0};
+static const NeoSprite spriteKeyed = {sprite565, NULL, 8, 8, NEO_SPRITE_RGB565, NEO_SPRITE_KEY, 0};
+
+// Each bench function makes one call to the primitive; i varies the arguments
+// so that every call touches a different part of the array
+static void benchSetPixel(int i)            { array.setPixel(i & 3, i & 7, (i >> 3) & 7, 0x123456); }
+static void benchSetPixelRGB(int i)         { array.setPixel(i & 3, i & 7, (i >> 3) & 7, 0x12, 0x34, 0x56); }
+static void benchDrawLine(int i)            { array.drawLine(i & 3, i & 7, 0, 7 - (i & 7), 7, 0x123456); }
+static void benchDrawRect(int i)            { array.drawRect(i & 3, i & 3, i & 3, 7 - (i & 3), 7, 0x123456); }
+static void benchDrawFilledRect(int i)      { array.drawFilledRect(i & 3, i & 3, i & 3, 7 - (i & 3), 7, 0x123456); }
+static void benchFillScreen(int i)          { array.fillScreen(i & 3, 0x123456); }
+static void benchDrawTriangle(int i)        { array.drawTriangle(i & 3, 0, 0, 7, i & 7, i & 7, 7, 0x123456); }
+static void benchDrawFilledTriangle(int i)  { array.drawFilledTriangle(i & 3, 0, 0, 7, i & 7, i & 7, 7, 0x123456); }
+static void benchDrawFilledTriangleFan(int i) { lineFanArray.drawFilledTriangleLineFan(i & 3, 0, 0, 7, i & 7, i & 7, 7, 0x12, 0x34, 0x56); }
+static void benchDrawCircle(int i)          { array.drawCircle(i & 3, 3, 4, 1 + (i & 3), 0x123456); }
+static void benchDrawFilledCircle(int i)    { array.drawFilledCircle(i & 3, 3, 4, 1 + (i & 3), 0x123456); }
+static void benchDrawEllipse(int i)         { array.drawEllipse(i & 3, 3, 4, 4, 1 + (i & 3), 0x123456); }
+static void benchDrawFilledEllipse(int i)   { array.drawFilledEllipse(i & 3, 3, 4, 4, 1 + (i & 3), 0x123456); }
+static void benchDrawArc(int i)             { array.drawArc(i & 3, 3, 4, 3, (i & 7) * 45, (i & 7) * 45 + 135, 0x123456); }
+static void benchDrawLineAA(int i)          { array.drawLineAA(i & 3, i & 7, 0, 7 - (i & 7), 7, 0x123456); }
+static void benchDrawCircleAA(int i)        { array.drawCircleAA(i & 3, 3, 4, 1 + (i & 3), 0x123456); }
+static void benchDrawFilledCircleAA(int i)  { array.drawFilledCircleAA(i & 3, 3, 4, 1 + (i & 3), 0x123456); }
+static void benchDrawFilledTriangleAA(int i){ array.drawFilledTriangleAA(i & 3, 0, 0, 7, i & 7, i & 7, 7, 0x123456); }
+static void benchDrawChar(int i)            { array.drawChar(i & 3, (i & 7) - 3, 0, 'A' + (i % 26), 0x123456); }
+static void benchDrawCharPerBit(int i)      { perBitArray.drawCharPerBit(i & 3, (i & 7) - 3, 0, 'A' + (i % 26), 0x12, 0x34, 0x56); }
+static void benchDrawLineCanvas(int i)      { array.drawLine(NEO_CANVAS, i & 31, 0, 31 - (i & 31), 7, 0x123456); }
+static void benchDrawCharCanvas(int i)      { array.drawChar(NEO_CANVAS, (i & 31) - 3, 0, 'A' + (i % 26), 0x123456); }
+static void benchDrawText(int i)            { char c[2] = {(char)('A' + (i % 26)), 0}; array.drawText(i & 3, (i & 7) - 3, 0, c, neo_font_plain, 0x123456); }
+static void benchDrawTextCanvas(int i)      { array.drawText(NEO_CANVAS, (i & 7) - 4, 0, "HELLO", neo_font_plain, 0x123456); }
+static void benchDrawTextUtf8(int i)        { array.drawText(NEO_CANVAS, (i & 7) - 4, 0, "Caf\xc3\xa9 \xe2\x82\xac""5", neo_font_plain, 0x123456); }     // "Café €5"
+static void benchShowImage(int i)           { array.showImage(i & 3, image); }
+static void benchBlit888(int i)             { array.blit(i & 3, 0, 0, sprite888); }
+static void benchBlitKeyed(int i)           { array.blit(i & 3, (i & 7) - 4, 0, spriteKeyed); }
+static void benchScrollRedraw(int i)        { array.clear(); for (int b = 0; b < PANELS; b++) array.drawChar(b, (i & 7) - 6, 0, 'A' + b, 0x123456); }
+static void benchScroll(int i)              { array.scroll(-1, 0, 0x000000); array.fillSpan(PANELS - 1, 7, 0, 8, 0x123456 + i); }
+static void benchMarquee(int i)             { marquee.update(i * 50); }     // one pixel every call at 20 pixels per second
+static void benchMarqueeSmooth(int i)       { smoothMarquee.update(i * 16); }     // a 60 frames per second step, about a third of a pixel
+static void benchRotate(int)                { array.rotate(-1, 0); }
+static void benchClear(int)                 { array.clear(); }
+static void benchColumnSetPixel(int i)      { for (int y = 0; y < 8; y++) array.setPixel(i & 3, i & 7, y, 0x123456 + i); }
+static void benchColumnFillSpan(int i)      { array.fillSpan(i & 3, i & 7, 0, 8, 0x123456 + i); }
+static void benchColumnWriteSpan(int i)     { array.writeSpan(i & 3, i & 7, 0, run + (i & 7), 8); }
+static void benchColumnPointer(int i)
+{
+    NeoColor *col = array.column(i & 3, i & 7);
+    for (int y = 0; y < 8; y++)
+        col[y] = run[(i + y) & 63];
+}
+static void benchWriteDither(int)           { ditherArray.write(); }
+static void benchRecolor(int i)
+{
+    // what hue cycling costs without a palette: every pixel recolored, then written
+    for (int b = 0; b < PANELS; b++)
+        for (int x = 0; x < 8; x++)
+            for (int y = 0; y < 8; y++)
+                array.setPixel(b, x, y, ((x * 8 + y + i) & 0xFF) * 0x010203);
+    array.write();
+}
+static void benchRotatePalette(int)
+{
+    indexedArray.rotatePalette(1, 255);
+    indexedArray.write();
+}
+static void benchCompositeTop(int i)
+{
+    compositor.layer(2)->setPixel(i & 3, i & 7, (i >> 3) & 7, 0x102030 + i);
+    compositor.write();
+}
+static void benchCompositeBottom(int i)
+{
+    compositor.layer(0)->setPixel(i & 3, i & 7, (i >> 3) & 7, 0x102030 + i);
+    compositor.write();
+}
+static void benchReplay(int i)              { scene.replay(array, (i & 3) - 2, 0); }
+static void benchReplayCached(int i)        { cachedScene.replay(array, (i & 3) - 2, 0); }
+static void benchTranspose8(int)            { neo_transpose8(laneBits, laneBits); }
+static void benchTransposeFrame(int)
+{
+    uint8_t bits[8];
+    for (int byte = 0; byte < parallel.length(); byte++)
+        parallel.transpose(byte, bits);
+}
+static void benchWrite(int)                 { array.invalidate(); array.write(); }
+static void benchWriteDma(int)              { dmaArray.invalidate(); dmaArray.write(); }
+
+struct Bench
+{
+    const char *name;
+    long calls;             // calls made at scale 1
+    void (*fn)(int);
+};
+
+static const Bench benches[] = {
+    {"setPixel(color)",     20000000, benchSetPixel},
+    {"setPixel(r,g,b)",     20000000, benchSetPixelRGB},
+    {"drawLine",             1000000, benchDrawLine},
+    {"drawRect",             2000000, benchDrawRect},
+    {"drawFilledRect",       2000000, benchDrawFilledRect},
+    {"fillScreen",           2000000, benchFillScreen},
+    {"drawTriangle",         1000000, benchDrawTriangle},
+    {"drawFilledTriangle",   1000000, benchDrawFilledTriangle},
+    {"drawFilledTriangle (fan)", 100000, benchDrawFilledTriangleFan},
+    {"drawCircle",           1000000, benchDrawCircle},
+    {"drawFilledCircle",     1000000, benchDrawFilledCircle},
+    {"drawEllipse",          1000000, benchDrawEllipse},
+    {"drawFilledEllipse",    1000000, benchDrawFilledEllipse},
+    {"drawArc",              1000000, benchDrawArc},
+    {"drawLineAA",           1000000, benchDrawLineAA},
+    {"drawCircleAA",         1000000, benchDrawCircleAA},
+    {"drawFilledCircleAA",   1000000, benchDrawFilledCircleAA},
+    {"drawFilledTriangleAA", 1000000, benchDrawFilledTriangleAA},
+    {"drawChar",             2000000, benchDrawChar},
+    {"drawChar (per-bit)",   2000000, benchDrawCharPerBit},
+    {"drawLine (canvas)",    1000000, benchDrawLineCanvas},
+    {"drawChar (canvas)",    2000000, benchDrawCharCanvas},
+    {"drawText",             2000000, benchDrawText},
+    {"drawText HELLO",       1000000, benchDrawTextCanvas},
+    {"drawText UTF-8",       1000000, benchDrawTextUtf8},
+    {"showImage",            2000000, benchShowImage},
+    {"blit RGB888",          2000000, benchBlit888},
+    {"blit RGB565 keyed",    2000000, benchBlitKeyed},
+    {"column via setPixel",  5000000, benchColumnSetPixel},
+    {"column via fillSpan",  5000000, benchColumnFillSpan},
+    {"column via writeSpan", 5000000, benchColumnWriteSpan},
+    {"column via column()",  5000000, benchColumnPointer},
+    {"scroll by redrawing",  1000000, benchScrollRedraw},
+    {"scroll + new column",  2000000, benchScroll},
+    {"marquee frame",        2000000, benchMarquee},
+    {"marquee frame (smooth)", 1000000, benchMarqueeSmooth},
+    {"rotate",               2000000, benchRotate},
+    {"clear",                2000000, benchClear},
+    {"write",                5000000, benchWrite},
+    {"write (DMA encode)",     200000, benchWriteDma},
+    {"write (dithered)",      1000000, benchWriteDither},
+    {"recolor + write",        100000, benchRecolor},
+    {"rotatePalette + write",  100000, benchRotatePalette},
+    {"composite (top)",       1000000, benchCompositeTop},
+    {"composite (bottom)",    1000000, benchCompositeBottom},
+    {"display list",          200000, benchReplay},
+    {"display list (cached)", 200000, benchReplayCached},
+    {"neo_transpose8",      20000000, benchTranspose8},
+    {"transpose 8 lanes",      20000, benchTransposeFrame},
+};
+
+int main(int argc, char **argv)
+{
+    int scale = argc > 1 ? atoi(argv[1]) : 1;
+    if (scale < 1)
+        scale = 1;
+
+    for (int i = 0; i < 64; i++)
+    {
+        image[i] = i * 0x040404;
+        run[i].green = i;
+        run[i].red = 2 * i;
+        run[i].blue = 3 * i;
+        sprite565[i] = (i & 3) ? i * 0x0841 : 0;
+    }
+
+    ditherArray.setDither(NEO_DITHER_TEMPORAL | NEO_DITHER_ORDERED);
+    for (int i = 0; i < PANELS; i++)
+        ditherArray.fillScreen(i, 0x808080);
+
+    // every index in use, so each rotation recolors the whole chain
+    indexedArray.setIndexed(true);
+    for (int b = 0; b < PANELS; b++)
+        for (int x = 0; x < 8; x++)
+            for (int y = 0; y < 8; y++)
+                indexedArray.setPixel(b, x, y, b * 64 + x * 8 + y);
+
+    // background, effect and overlay layers
+    compositor.setBlend(1, NEO_BLEND_ADD);
+    compositor.setBlend(2, NEO_BLEND_SCREEN);
+    compositor.setOpacity(1, 160);
+    for (int i = 0; i < PANELS; i++)
+    {
+        compositor.layer(0)->fillScreen(i, 0x201008);
+        compositor.layer(1)->drawFilledCircleAA(i, 3, 4, 3, 0x0040C0);
+    }
+    compositor.write();
+
+    // the same picture on every board, drawn by commands and from its cache
+    for (int i = 0; i < PANELS; i++)
+    {
+        NeoList *l[] = {&scene, &cachedScene};
+        for (int k = 0; k < 2; k++)
+        {
+            l[k]->fillScreen(i, 0x000010);
+            l[k]->drawFilledCircle(i, 3, 4, 3, 0x0040C0);
+            l[k]->drawFilledTriangle(i, 0, 0, 7, 2, 2, 7, 0x401000);
+            l[k]->drawLine(i, 0, 7, 7, 0, 0xFFFFFF);
+            l[k]->drawRect(i, 0, 0, 7, 7, 0x808000);
+        }
+    }
+    cachedScene.setCached(true);
+
+    marquee.setRepeat(true);
+    marquee.show("THANKS FOR WATCHING THE DEMO", 0x80FF80);
+    smoothMarquee.setRepeat(true);
+    smoothMarquee.setSmooth(true);
+    smoothMarquee.show("THANKS FOR WATCHING THE DEMO", 0x80FF80);
+
+    // 8 chains of PANELS boards, each recorded once so every lane has a full frame
+    for (int i = 0; i < NEO_MAX_LANES; i++)
+    {
+        laneArray[i] = new NeoArr(parallel.lane(i), PANELS);
+        laneArray[i]->fillScreen(0, 0x010203 * i);
+        laneArray[i]->write();
+    }
+
+    printf("%-24s %12s %12s %12s\n", "primitive", "calls", "ns/call", "Mcalls/s");
+    for (unsigned b = 0; b < sizeof(benches) / sizeof(benches[0]); b++)
+    {
+        long calls = benches[b].calls * scale;
+        array.clear();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (long i = 0; i < calls; i++)
+            benches[b].fn((int)i);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        printf("%-24s %12ld %12.1f %12.2f\n", benches[b].name, calls, ns / calls, calls / ns * 1000.0);
+    }
+
+    printf("\n");
+    NeoProfile::dumpAll();
+    return 0;
+}
+
+#endif
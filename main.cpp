@@ -7,6 +7,8 @@
 
 #include "mbed.h"
 #include "NeoMatrix.h"
+#include "NeoMarquee.h"
+#include "NeoFrame.h"
 
 #define Color(r, g, b)  ((r&0xFF)<<16 | (g&0xFF) << 8 | (b&0xFF))   // pack colors
 
@@ -40,18 +42,13 @@ inline microphone::operator float ()
 
 microphone mymicrophone(p16);
 
-int hueToRGB(float h);
 void float2LED(float value)
 {
     float fnumLED = abs((value - 0.5)/3.3)*100; // adjust for LED
     int numLED = (int)fnumLED;
     if (numLED > 8) numLED = 8;
     
-    static float dh = 360.0 / 5;
-    static float x = 0;
-    
     for(int i = 0; i < numLED; i++){
-        int c = hueToRGB((dh * i) - x);
         array.setPixel(0, 1, 1, 0xff0000);
         array.setPixel(0, i+1, i+1, 0xff0000);
         array.setPixel(0, i+2, i+2, 0xff0000);
@@ -66,16 +63,10 @@ void float2LED(float value)
         array.setPixel(0, i+3, i+3, 0xff0000);
         array.setPixel(0, i+4, i+4, 0xff0000);
         }
-    x += 1;
-    if (x > 360)
-        x = 0;
 }
 
 // also for the microphone
 void mic2LED(int mic){
-    static float dh = 360.0 / 5;
-    static float x = 0;
-    
     int numLED = 0;
     if(mic == 0) numLED = 0;
     else if(mic == 1) numLED = 1;
@@ -88,34 +79,23 @@ void mic2LED(int mic){
     else if(mic == 8) numLED = 8;
     
     for(int i = 0; i < numLED; i++){
-        int c = hueToRGB((dh * i) - x);
         for(int n=0; n<1; n++){
         for(int i=-8; i<8; i+=2){
         array.drawLine(0, i+n%2,0,i+7+n%2,7,rand()%255,rand()%255,rand()%255);
                     }
                 }
-    x += 1;
-    if (x > 360)
-        x = 0; 
+    }
 }
 
-unsigned short max_range = 0xFFFF;
-// call above function
+// samples the microphone and shows it on the array for the given number of frames
+void visualizer(int frames)
 {
-    //for(int i = 0; i < 60; i++){
         float sample;
         float average = 0.67/3.3;//initial DC bias
         
         int buffer[20];
         
-        while(1){
-            if (src) {
-            float test = (float)waver.dac_data/max_range;
-            pc.printf("--%f", abs((test - 0.5)/3.3));
-            float2LED(test);
-            array.write();
-            }
-            else {
+        for(int f = 0; f < frames; f++){
             //microphone setup //
             int centervalue;
             for(int i = 0; i < 20; i++){
@@ -139,12 +119,28 @@ unsigned short max_range = 0xFFFF;
                 mic2LED(2+offset);
                 wait(1.0/4000.0);
                 }
-                n+=1;
                 wait_ms(100);
             array.write();
-            }
         }
+}
 
+// scrolls the letters across the array one at a time, each in its own color
+void scrollLetters(NeoMarquee &marquee, NeoFrameTimer &frames, Timer &t, const char *letters, const int *colors)
+{
+    // keep letters queued and draw a frame whenever one is due
+    int next = 0;
+    while (letters[next] || !marquee.idle())
+    {
+        char text[2] = { letters[next], 0 };
+        if (letters[next] && marquee.show(text, colors[next]))
+            next++;
+        if (frames.due(t.read_us()))
+        {
+            marquee.update(t.read_ms());
+            array.write();
+        }
+    }
+}
 
 int main()
 {
@@ -154,81 +150,28 @@ int main()
     array.setBrightness(bright);    // ^^ default
     array.clear();
 
+    const int nameColors[] = {Color(255,255,255), Color(255,0,255), Color(128,255,128), Color(0,255,0)};
+    const int thanksColors[] = {Color(128,255,128), Color(255,255,0), Color(255,0,255), Color(255,128,128), Color(255,255,128), Color(255,255,255)};
+
+    NeoMarquee marquee(&array, 0, 0, 8);
+    marquee.setSpeed(10);       // the pace of the old 100 ms steps, moving by fractions of a pixel
+    marquee.setSmooth(true);
+    NeoFrameTimer frames(60);
+    Timer t;
+    t.start();
+
     while (true)
     {
-           //Horizontal Scroll ZACH
-           for(int i=7;i>=-6;i--){
-                char c = 'Z';
-                array.clear();
-                array.drawChar(0,i,0,c, 255,255,255);
-                array.write();
-                wait_ms(100);
-            }
-            for(int i=7;i>=-6;i--){
-                char c = 'A';
-                array.clear();
-                array.drawChar(0,i,0,c, 255,0,255);
-                array.write();
-                wait_ms(100);
-            }
-            for(int i=7;i>=-6;i--){
-                char c = 'C';
-                array.clear();
-                array.drawChar(0,i,0,c, 128,255,128);
-                array.write();
-                wait_ms(100);
-            }
-            for(int i=7;i>=-6;i--){
-                char c = 'H';
-                array.clear();
-                array.drawChar(0,i,0,c, 0,255,0);
-                array.write();
-                wait_ms(100);
-            }    
+        //Horizontal Scroll ZACH
+        scrollLetters(marquee, frames, t, "ZACH", nameColors);
+
+        // about a minute of the audio visualizer
+        visualizer(600);
+
 ///////////////////////////     
 // Scrolling Thanks for watching the demo 
-                for(int i=7;i>=-6;i--){
-                char c = 'T';
-                array.clear();
-                array.drawChar(0,i,0,c, 128,255,128);
-                array.write();
-                wait_ms(100);
-                }
-                                for(int i=7;i>=-6;i--){
-                char c = 'H';
-                array.clear();
-                array.drawChar(0,i,0,c, 255,255,0);
-                array.write();
-                wait_ms(100);
-                }
-                                for(int i=7;i>=-6;i--){
-                char c = 'A';
-                array.clear();
-                array.drawChar(0,i,0,c, 255,0,255);
-                array.write();
-                wait_ms(100);
-                }
-                                for(int i=7;i>=-6;i--){
-                char c = 'N';
-                array.clear();
-                array.drawChar(0,i,0,c, 255,128,128);
-                array.write();
-                wait_ms(100);
-                }
-                                for(int i=7;i>=-6;i--){
-                char c = 'K';
-                array.clear();
-                array.drawChar(0,i,0,c, 255,255,128);
-                array.write();
-                wait_ms(100);
-                }
-                                for(int i=7;i>=-6;i--){
-                char c = 'S';
-                array.clear();
-                array.drawChar(0,i,0,c, 255,255,255);
-                array.write();
-                wait_ms(100);
-                }
+        scrollLetters(marquee, frames, t, "THANKS", thanksColors);
+
                         // Shrink rectangle to close out program
         for(int i=0; i<4; i++){
             array.clear();
@@ -237,6 +180,4 @@ int main()
             wait_ms(250);
             }
         }
-    }
 }
-
@@ -0,0 +1,66 @@
+/**********************************************
+ * NeoCompositorTest.cpp
+ *
+ *  Host test for NeoCompositor. A pixel drawn on a cleared layer over a red
+ *  background must cover the whole background with NEO_BLEND_ALPHA and only
+ *  that pixel with NEO_BLEND_KEY, and mix by the layer's opacity.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoCompositorTest.cpp NeoMatrix/Neo*.cpp -o neocompositortest
+ *      ./neocompositortest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include "NeoMatrix.h"
+#include "NeoCompositor.h"
+#include "NeoTest.h"
+
+// counts the pixels of the board that are not color, and checks pixel (2, 3)
+static void check(const char *name, const NeoMemorySink &sink, int color, int dot)
+{
+    int others = 0;
+    for (int i = 0; i < 64; i++)
+        if (i != 2*8 + 3 && sink.pixel(i) != color)
+            others++;
+    NEO_CHECK(others == 0, "%s: %d pixels are not %06X", name, others, color);
+    NEO_CHECK(sink.pixel(2*8 + 3) == dot, "%s: pixel (2, 3) is %06X, expected %06X", name, sink.pixel(2*8 + 3), dot);
+}
+
+int main()
+{
+    NeoMemorySink sink(64);
+    NeoArr out(&sink, 1);
+    out.setBrightness(1.0f);
+    out.setGamma(1.0f);
+
+    NeoCompositor c(&out, 1, 2);
+    c.layer(0)->fillScreen(0, 0xFF0000);
+    c.layer(1)->setPixel(0, 2, 3, 0xFFFFFF);
+
+    // the black of the overlay covers the background
+    c.write();
+    check("alpha", sink, 0x000000, 0xFFFFFF);
+
+    // only the pixel drawn on the overlay covers it
+    c.setBlend(1, NEO_BLEND_KEY);
+    c.write();
+    check("key", sink, 0xFF0000, 0xFFFFFF);
+
+    c.setOpacity(1, 128);
+    c.write();
+    check("key at half opacity", sink, 0xFF0000, 0xFF8080);
+
+    // another key color: the overlay filled blue around a white pixel
+    c.setOpacity(1, 255);
+    c.setKey(1, 0x0000FF);
+    c.layer(1)->fillScreen(0, 0x0000FF);
+    c.layer(1)->setPixel(0, 2, 3, 0xFFFFFF);
+    c.write();
+    check("blue key", sink, 0xFF0000, 0xFFFFFF);
+
+    return neo_test_done("NeoCompositorTest");
+}
+
+#endif
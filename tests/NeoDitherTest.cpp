@@ -0,0 +1,98 @@
+/**********************************************
+ * NeoDitherTest.cpp
+ *
+ *  Host test for NeoDither. A flat, dim color whose output values fall between
+ *  two steps is dithered and the mean of what reaches the sink, over frames
+ *  (temporal), over a board (ordered) or both, must come out at the exact
+ *  brightness and gamma corrected value.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoDitherTest.cpp NeoMatrix/Neo*.cpp -o neodithertest
+ *      ./neodithertest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <math.h>
+#include "NeoMatrix.h"
+#include "NeoTest.h"
+
+#define PANELS      2
+#define BRIGHT      0.1f
+#define COLOR       0x643CB4        // 100, 60, 180: 3.25, 1.05 and 9.76 out of 255 at BRIGHT
+
+// the output each channel value should average to
+static double ideal(int v)
+{
+    return 255.0 * BRIGHT * pow(v / 255.0, (double)NEO_GAMMA);
+}
+
+// mean error of each channel over frames of the whole chain
+static double meanError(int mode, int frames, double *worst)
+{
+    NeoMemorySink sink(PANELS * 64);
+    NeoArr a(&sink, PANELS);
+    a.setBrightness(BRIGHT);
+    a.setDither(mode);
+    for (int b = 0; b < PANELS; b++)
+        a.fillScreen(b, COLOR);
+
+    double sum[3] = {0, 0, 0};
+    for (int f = 0; f < frames; f++)
+    {
+        a.write();
+        for (int i = 0; i < PANELS * 64; i++)
+        {
+            int c = sink.pixel(i);
+            sum[0] += (c >> 16) & 0xFF;
+            sum[1] += (c >> 8) & 0xFF;
+            sum[2] += c & 0xFF;
+        }
+    }
+
+    *worst = 0;
+    for (int k = 0; k < 3; k++)
+    {
+        double e = fabs(sum[k] / (frames * PANELS * 64) - ideal((COLOR >> (16 - 8*k)) & 0xFF));
+        if (e > *worst)
+            *worst = e;
+    }
+    return *worst;
+}
+
+int main()
+{
+    double worst;
+
+    // without dithering each channel rounds to the nearest step, a quarter step off or more
+    meanError(NEO_DITHER_OFF, 1, &worst);
+    NEO_CHECK(worst > 0.2, "test color rounds too close to a step (%.3f) to show dithering", worst);
+
+    // temporal: the error carried from frame to frame averages out over 256 frames
+    meanError(NEO_DITHER_TEMPORAL, 256, &worst);
+    NEO_CHECK(worst < 0.01, "temporal mean error %.4f", worst);
+
+    // ordered: the Bayer thresholds average out over each 8x8 board in one frame
+    meanError(NEO_DITHER_ORDERED, 1, &worst);
+    NEO_CHECK(worst < 1 / 64.0 + 1 / 256.0, "ordered mean error %.4f", worst);
+
+    meanError(NEO_DITHER_TEMPORAL | NEO_DITHER_ORDERED, 256, &worst);
+    NEO_CHECK(worst < 0.01, "temporal + ordered mean error %.4f", worst);
+
+    // a change that dithers to the same output is not sent
+    NeoMemorySink sink(PANELS * 64);
+    NeoArr a(&sink, PANELS);
+    a.setBrightness(BRIGHT);
+    a.setDither(NEO_DITHER_ORDERED);
+    a.fillScreen(0, COLOR);
+    a.write();
+    int frames = sink.frames();
+    a.setPixel(1, 3, 3, 0x010101);     // rounds to 0 at BRIGHT, like the black around it
+    a.write();
+    NEO_CHECK(sink.frames() == frames, "unchanged ordered output sent %d times", sink.frames() - frames);
+
+    return neo_test_done("NeoDitherTest");
+}
+
+#endif
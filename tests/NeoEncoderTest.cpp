@@ -0,0 +1,102 @@
+/**********************************************
+ * NeoEncoderTest.cpp
+ *
+ *  Host test for NeoEncoder. Known colors are encoded at the 3 and 4 bit
+ *  rates, the SPI bytes are decoded back into WS2812 bits, and every pulse is
+ *  checked against the WS2812 timing windows in NeoEncoder.h.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoEncoderTest.cpp NeoMatrix/Neo*.cpp -o neoencodertest
+ *      ./neoencodertest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <stdlib.h>
+#include <string.h>
+#include "NeoEncoder.h"
+#include "NeoTest.h"
+
+#define PIXELS  9       // odd, so the 3 bit kernel also runs its leftover bytes
+
+static const int colors[PIXELS] = {0x000000, 0xFFFFFF, 0xFF0000, 0x00FF00, 0x0000FF, 0xA55A3C, 0x010080, 0x7F7F7F, 0x123456};
+
+// SPI bit k of the stream, most significant bit of each byte first
+static int spiBit(const uint8_t *out, int k)
+{
+    return (out[k >> 3] >> (7 - (k & 7))) & 1;
+}
+
+static void testRate(int bits)
+{
+    NeoEncoder enc(bits);
+    double ns = 1e9 / enc.frequency();     // one SPI bit
+
+    NEO_CHECK(enc.valid(), "%d bit encoder at %d Hz outside the WS2812 windows", bits, enc.frequency());
+    NEO_CHECK(enc.t0h() >= NEO_T0H_MIN && enc.t0h() <= NEO_T0H_MAX, "%d bit T0H %d ns", bits, enc.t0h());
+    NEO_CHECK(enc.t1h() >= NEO_T1H_MIN && enc.t1h() <= NEO_T1H_MAX, "%d bit T1H %d ns", bits, enc.t1h());
+    NEO_CHECK(enc.tbit() >= NEO_TBIT_MIN && enc.tbit() <= NEO_TBIT_MAX, "%d bit bit time %d ns", bits, enc.tbit());
+
+    for (int n = 1; n <= PIXELS; n++)
+    {
+        NeoColor px[PIXELS];
+        for (int i = 0; i < n; i++)
+        {
+            px[i].red = colors[i] >> 16;
+            px[i].green = colors[i] >> 8;
+            px[i].blue = colors[i];
+        }
+
+        // a guard byte past the end shows any overrun
+        int len = enc.length(n);
+        uint32_t words[(PIXELS * 3 * 4 + 256) / 4 + 2];
+        uint8_t *out = (uint8_t*)words;
+        memset(out, 0xEE, sizeof(words));
+        NEO_CHECK(enc.encode(px, n, out) == len, "%d bit, %d pixels: encode() length", bits, n);
+        NEO_CHECK(out[len] == 0xEE, "%d bit, %d pixels: wrote past length()", bits, n);
+
+        // decode each LED bit from its SPI bits and check the pulse it makes
+        const uint8_t *data = (const uint8_t*)px;
+        for (int b = 0; b < n * 24; b++)
+        {
+            int high = 0;
+            while (high < bits && spiBit(out, b * bits + high))
+                high++;
+            int rest = 0;
+            for (int k = high; k < bits; k++)
+                rest |= spiBit(out, b * bits + k);
+            int value = (data[b / 8] >> (7 - b % 8)) & 1;
+
+            NEO_CHECK(rest == 0, "%d bit, LED bit %d: high again after going low", bits, b);
+            NEO_CHECK(high == (value ? 2 : 1), "%d bit, LED bit %d: %d high SPI bits for a %d", bits, b, high, value);
+            double t = high * ns;
+            if (value)
+                NEO_CHECK(t >= NEO_T1H_MIN && t <= NEO_T1H_MAX, "%d bit, LED bit %d: T1H %.0f ns", bits, b, t);
+            else
+                NEO_CHECK(t >= NEO_T0H_MIN && t <= NEO_T0H_MAX, "%d bit, LED bit %d: T0H %.0f ns", bits, b, t);
+        }
+
+        // the reset pulse: the line held low for at least NEO_TRESET
+        int start = n * 3 * bits;
+        int zero = 1;
+        for (int k = start; k < len; k++)
+            zero &= (out[k] == 0);
+        NEO_CHECK(zero, "%d bit, %d pixels: reset bytes not low", bits, n);
+        NEO_CHECK((len - start) * 8 * ns >= NEO_TRESET, "%d bit: reset only %.0f ns", bits, (len - start) * 8 * ns);
+    }
+}
+
+int main()
+{
+    testRate(3);
+    testRate(4);
+
+    // a clock too slow for the pulses must be refused
+    NeoEncoder slow(3, 1000000);
+    NEO_CHECK(!slow.valid(), "3 bit encoder at 1 MHz accepted");
+
+    return neo_test_done("NeoEncoderTest");
+}
+
+#endif
@@ -0,0 +1,58 @@
+/**********************************************
+ * NeoFrameTest.cpp
+ *
+ *  Host test for NeoFrameTimer: frames come due on a fixed schedule, a late
+ *  loop skips the frames it missed, the schedule survives the microsecond
+ *  clock wrapping, and rates too high for a whole microsecond period still run.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoFrameTest.cpp NeoMatrix/Neo*.cpp -o neoframetest
+ *      ./neoframetest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include "NeoFrame.h"
+#include "NeoTest.h"
+
+// polls a timer every step microseconds from start for us microseconds and counts the frames due
+static int run(NeoFrameTimer &t, uint32_t start, uint32_t us, uint32_t step)
+{
+    int n = 0;
+    for (uint32_t k = 0; k < us; k += step)
+        n += t.due(start + k);
+    return n;
+}
+
+int main()
+{
+    // 60 fps polled every 100 us for one second
+    NeoFrameTimer a(60);
+    int n = run(a, 0, 1000000, 100);
+    NEO_CHECK(n == 60, "60 fps gave %d frames in a second", n);
+    NEO_CHECK(a.missed() == 0, "60 fps missed %u frames", (unsigned)a.missed());
+
+    // polled every 50 ms, most frames are over before the loop gets to them
+    NeoFrameTimer b(60);
+    n = run(b, 0, 1000000, 50000);
+    NEO_CHECK(n == 20, "slow loop drew %d frames", n);
+    NEO_CHECK(n + (int)b.missed() == 58, "slow loop drew %d and missed %u", n, (unsigned)b.missed());   // due by the last poll at 950 ms
+
+    // across the wrap of the clock
+    NeoFrameTimer c(100);
+    n = run(c, 0xFFFFFFFFu - 500000, 1000000, 100);
+    NEO_CHECK(n == 100, "100 fps across the wrap gave %d frames", n);
+
+    // a period under a microsecond is held at one
+    NeoFrameTimer d(2000000);
+    n = run(d, 0, 100, 1);
+    NEO_CHECK(n == 100, "2000000 fps polled every microsecond gave %d frames", n);
+    d.setRate(0);
+    n = run(d, 100, 3000000, 1000);
+    NEO_CHECK(n == 3, "a rate of 0 gave %d frames in 3 seconds", n);
+
+    return neo_test_done("NeoFrameTest");
+}
+
+#endif
@@ -0,0 +1,127 @@
+/**********************************************
+ * NeoLayoutTest.cpp
+ *
+ *  Host test for NeoLayout and NeoArr::setLayout(). The layout table NeoArr
+ *  builds, map[x*height + y], is checked against chain indices worked out by
+ *  hand for serpentine grids and for rotated and flipped boards, and must use
+ *  every chain index exactly once.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoLayoutTest.cpp NeoMatrix/Neo*.cpp -o neolayouttest
+ *      ./neolayouttest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <string.h>
+#include "NeoMatrix.h"
+#include "NeoTest.h"
+
+static NeoNullSink nullSink;
+
+// gives the test the layout table
+class MapArr : public NeoArr
+{
+    public:
+        MapArr(int N) : NeoArr(&nullSink, N) {}
+        int at(int x, int y) const { return map[x*height + y]; }
+        int w() const { return width; }
+        int h() const { return height; }
+};
+
+// a canvas pixel and the chain index it must map to
+typedef struct _Expect
+{
+    int x, y, index;
+} Expect;
+
+static void check(const char *name, const NeoLayout &layout, const Expect *expect, int n)
+{
+    MapArr a(layout.tiles());
+    a.setLayout(layout);
+    NEO_CHECK(a.w() == layout.width() && a.h() == layout.height(), "%s: canvas %dx%d", name, a.w(), a.h());
+
+    for (int i = 0; i < n; i++)
+        NEO_CHECK(a.at(expect[i].x, expect[i].y) == expect[i].index, "%s: (%d, %d) maps to %d, expected %d",
+                  name, expect[i].x, expect[i].y, a.at(expect[i].x, expect[i].y), expect[i].index);
+
+    // a permutation of the chain
+    static bool seen[NEO_MAX_TILES * 64];
+    memset(seen, 0, sizeof(seen));
+    bool ok = true;
+    for (int x = 0; x < a.w(); x++)
+        for (int y = 0; y < a.h(); y++)
+        {
+            int i = a.at(x, y);
+            if (i < 0 || i >= layout.tiles() * 64 || seen[i])
+                ok = false;
+            else
+                seen[i] = true;
+        }
+    NEO_CHECK(ok, "%s: table is not a permutation of the chain", name);
+}
+
+int main()
+{
+    // boards chained 0, 1 along the bottom row and 2, 3 back along the top
+    NeoLayout serp(2, 2, true);
+    const Expect serpExpect[] = {
+        {0, 0, 0}, {7, 7, 63}, {9, 3, 75}, {15, 0, 120},
+        {9, 11, 139}, {15, 15, 191}, {8, 8, 128},
+        {2, 12, 212}, {0, 8, 192}, {7, 15, 255},
+    };
+    check("2x2 serpentine", serp, serpExpect, sizeof(serpExpect) / sizeof(serpExpect[0]));
+
+    // the same grid chained left to right on both rows
+    NeoLayout rows(2, 2, false);
+    const Expect rowsExpect[] = {{9, 11, 203}, {2, 12, 148}};
+    check("2x2 rows", rows, rowsExpect, 2);
+
+    // one board in each orientation; (3, 5) is the canvas pixel 3 across and 5 up
+    NeoLayout r90(1);
+    r90.setTile(0, 0, NEO_ROTATE_90);
+    const Expect r90Expect[] = {{0, 7, 0}, {0, 0, 56}, {7, 0, 63}, {3, 5, 19}};
+    check("rotate 90", r90, r90Expect, 4);
+
+    NeoLayout r180(1);
+    r180.setTile(0, 0, NEO_ROTATE_180);
+    const Expect r180Expect[] = {{7, 7, 0}, {0, 0, 63}, {3, 5, 34}};
+    check("rotate 180", r180, r180Expect, 3);
+
+    NeoLayout r270(1);
+    r270.setTile(0, 0, NEO_ROTATE_270);
+    const Expect r270Expect[] = {{7, 0, 0}, {0, 0, 7}, {3, 5, 44}};
+    check("rotate 270", r270, r270Expect, 3);
+
+    NeoLayout fx(1);
+    fx.setTile(0, 0, NEO_FLIP_X);
+    const Expect fxExpect[] = {{7, 0, 0}, {0, 0, 56}, {3, 5, 37}};
+    check("flip x", fx, fxExpect, 3);
+
+    NeoLayout fy(1);
+    fy.setTile(0, 0, NEO_FLIP_Y);
+    const Expect fyExpect[] = {{0, 7, 0}, {0, 0, 7}, {3, 5, 26}};
+    check("flip y", fy, fyExpect, 3);
+
+    NeoLayout r90fx(1);
+    r90fx.setTile(0, 0, NEO_ROTATE_90 | NEO_FLIP_X);
+    const Expect r90fxExpect[] = {{7, 7, 0}, {3, 5, 20}};
+    check("rotate 90 + flip x", r90fx, r90fxExpect, 2);
+
+    // a row of three with the middle board upside down
+    NeoLayout mixed(3);
+    mixed.setTile(1, 0, NEO_ROTATE_180);
+    const Expect mixedExpect[] = {{7, 7, 63}, {8, 0, 127}, {15, 7, 64}, {11, 2, 101}, {16, 0, 128}, {23, 7, 191}};
+    check("3x1, middle rotated 180", mixed, mixedExpect, 6);
+
+    // serpentine with a turned board on the way back
+    NeoLayout turned(2, 2, true);
+    turned.setTile(0, 1, NEO_ROTATE_270);
+    const Expect turnedExpect[] = {{0, 8, 199}, {7, 8, 192}, {3, 13, 236}, {8, 8, 128}};
+    check("2x2 serpentine, one rotated 270", turned, turnedExpect, 4);
+
+    return neo_test_done("NeoLayoutTest");
+}
+
+#endif
@@ -0,0 +1,106 @@
+/**********************************************
+ * NeoLineTest.cpp
+ *
+ *  Host test for NeoArr::drawLine(). Every line between two points of a 24x24
+ *  range is drawn and compared pixel for pixel with a plain Bresenham that
+ *  checks the bounds of each pixel it plots, once on a board in the middle of a
+ *  row, where the range reaches 8 pixels past each edge, and once on a 3x3
+ *  board canvas.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoLineTest.cpp NeoMatrix/Neo*.cpp -o neolinetest
+ *      ./neolinetest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <stdlib.h>
+#include <string.h>
+#include "NeoMatrix.h"
+#include "NeoTest.h"
+
+static NeoNullSink nullSink;
+
+// gives the test the pixel buffer
+class PixelArr : public NeoArr
+{
+    public:
+        PixelArr(int N) : NeoArr(&nullSink, N) {}
+        bool lit(int i) const { return arr[i].red || arr[i].green || arr[i].blue; }
+};
+
+// marks the pixels of the line from (x1, y1) to (x2, y2) inside a w by h area:
+// step i along the longer axis moves (2*i*db + da) / (2*da) along the shorter one
+static void reference(bool *lit, int w, int h, int x1, int y1, int x2, int y2)
+{
+    bool steep = abs(y2-y1) > abs(x2-x1);
+    int da = steep ? abs(y2-y1) : abs(x2-x1);
+    int db = steep ? abs(x2-x1) : abs(y2-y1);
+    int sx = (x2 < x1) ? -1 : 1;
+    int sy = (y2 < y1) ? -1 : 1;
+
+    for (int i = 0; i <= da; i++)
+    {
+        int m = da ? (2*i*db + da) / (2*da) : 0;
+        int x = x1 + sx * (steep ? m : i);
+        int y = y1 + sy * (steep ? i : m);
+        if (x >= 0 && x < w && y >= 0 && y < h)
+            lit[x*h + y] = true;
+    }
+}
+
+// draws every line with ends in lo..lo+23 on idx and compares with the reference;
+// chain[x*h + y] is the chain index of pixel (x, y) of the w by h area drawn on
+static void check(const char *name, PixelArr &a, int idx, int w, int h, const int *chain, int n, int lo)
+{
+    static bool lit[24*24];
+    for (int x1 = lo; x1 < lo + 24; x1++)
+        for (int y1 = lo; y1 < lo + 24; y1++)
+            for (int x2 = lo; x2 < lo + 24; x2++)
+                for (int y2 = lo; y2 < lo + 24; y2++)
+                {
+                    a.clear();
+                    a.drawLine(idx, x1, y1, x2, y2, 0xFFFFFF);
+
+                    memset(lit, 0, sizeof(lit));
+                    reference(lit, w, h, x1, y1, x2, y2);
+
+                    int count = 0;
+                    bool ok = true;
+                    for (int i = 0; i < w*h; i++)
+                    {
+                        if (lit[i] != a.lit(chain[i]))
+                            ok = false;
+                        count += lit[i];
+                    }
+                    for (int i = 0; i < n; i++)     // nothing outside the area
+                        count -= a.lit(i);
+                    NEO_CHECK(ok && count == 0, "%s: line (%d, %d) to (%d, %d)", name, x1, y1, x2, y2);
+                }
+}
+
+int main()
+{
+    static int chain[24*24];
+
+    // board 1 of a row of 3, so a line that is not clipped would reach its neighbours
+    PixelArr row(3);
+    for (int x = 0; x < 8; x++)
+        for (int y = 0; y < 8; y++)
+            chain[x*8 + y] = 64 + x*8 + y;
+    check("board", row, 1, 8, 8, chain, 3*64, -8);
+
+    // the whole canvas of a 3x3 grid, with the range reaching 4 pixels past each edge
+    NeoLayout grid(3, 3);
+    PixelArr canvas(9);
+    canvas.setLayout(grid);
+    for (int x = 0; x < 24; x++)
+        for (int y = 0; y < 24; y++)
+            chain[x*24 + y] = grid.index(x, y);
+    check("canvas", canvas, NEO_CANVAS, 24, 24, chain, 9*64, -4);
+
+    return neo_test_done("NeoLineTest");
+}
+
+#endif
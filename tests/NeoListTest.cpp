@@ -0,0 +1,104 @@
+/**********************************************
+ * NeoListTest.cpp
+ *
+ *  Host test for cached NeoList replays. A list replayed from its cache must
+ *  leave every pixel as drawing the same list again would, on a single row of
+ *  boards and on grids of more than one row, for lists that draw on boards and
+ *  on NEO_CANVAS.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoListTest.cpp NeoMatrix/Neo*.cpp -o neolisttest
+ *      ./neolisttest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <string.h>
+#include "NeoMatrix.h"
+#include "NeoList.h"
+#include "NeoTest.h"
+
+#define BOARDS  6
+
+static NeoNullSink nullSink;
+
+// gives the test the pixel buffer
+class PixelArr : public NeoArr
+{
+    public:
+        PixelArr(int N) : NeoArr(&nullSink, N) {}
+        const NeoColor *pixels() const { return arr; }
+};
+
+// shapes that fit the canvas of the layout, or board 1, when not moved: the cache
+// only keeps what the list draws with no offset
+static void record(NeoList &list, const NeoLayout &layout, bool canvas)
+{
+    int idx = canvas ? NEO_CANVAS : 1;
+    int w = canvas ? layout.width() : 8;
+    int h = canvas ? layout.height() : 8;
+    list.drawLine(idx, 0, 0, w - 1, h - 1, 0xFF0000);
+    list.drawFilledCircle(idx, w - 4, h - 4, 3, 0x00FF00);
+    list.drawRect(idx, 1, 1, 6, 6, 0x0000FF);
+    list.drawChar(idx, 1, 0, 'A', 0xFFFFFF);
+    if (!canvas)
+        list.drawLine(4, 0, 7, 7, 0, 0xFFFF00);
+}
+
+// replays the list cached and uncached at a few offsets and compares the pixels
+static void check(const char *name, const NeoLayout &layout, bool canvas)
+{
+    NeoList plain(BOARDS), cached(BOARDS);
+    record(plain, layout, canvas);
+    record(cached, layout, canvas);
+    cached.setCached(true);
+
+    PixelArr a(BOARDS), b(BOARDS);
+    a.setLayout(layout);
+    b.setLayout(layout);
+
+    const int offsets[][2] = { {0, 0}, {3, -2}, {-7, 5}, {9, 8} };
+    for (int k = 0; k < 4; k++)
+    {
+        a.fillScreen(NEO_CANVAS, 0x202020);
+        b.fillScreen(NEO_CANVAS, 0x202020);
+        plain.replay(a, offsets[k][0], offsets[k][1]);
+        cached.replay(b, offsets[k][0], offsets[k][1]);
+        NEO_CHECK(memcmp(a.pixels(), b.pixels(), BOARDS*64*sizeof(NeoColor)) == 0,
+                  "%s: cached replay at (%d, %d) differs", name, offsets[k][0], offsets[k][1]);
+    }
+}
+
+int main()
+{
+    NeoLayout row(BOARDS);
+    NeoLayout grid(2, 3);
+    NeoLayout serp(3, 2, true);
+    serp.setTile(1, 1, NEO_ROTATE_90);
+
+    check("row, boards", row, false);
+    check("row, canvas", row, true);
+    check("2x3, boards", grid, false);
+    check("2x3, canvas", grid, true);
+    check("3x2 serpentine, boards", serp, false);
+    check("3x2 serpentine, canvas", serp, true);
+
+    // the cache follows the grid of the array it is replayed on
+    NeoList plain(BOARDS), cached(BOARDS);
+    record(plain, grid, true);
+    record(cached, grid, true);
+    cached.setCached(true);
+    PixelArr a(BOARDS), b(BOARDS);
+    cached.replay(b, 0, 0);
+    b.clear();
+    a.setLayout(grid);
+    b.setLayout(grid);
+    plain.replay(a, 1, 1);
+    cached.replay(b, 1, 1);
+    NEO_CHECK(memcmp(a.pixels(), b.pixels(), BOARDS*64*sizeof(NeoColor)) == 0, "cache not redrawn for a new grid");
+
+    return neo_test_done("NeoListTest");
+}
+
+#endif
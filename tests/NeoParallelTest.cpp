@@ -0,0 +1,108 @@
+/**********************************************
+ * NeoParallelTest.cpp
+ *
+ *  Host test for neo_transpose8 and NeoParallel::transpose(). Both are compared
+ *  with a transpose done one bit at a time, for single bits, random blocks and
+ *  lanes of different lengths, where the lanes that are shorter or unused must
+ *  send zeros.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoParallelTest.cpp NeoMatrix/Neo*.cpp -o neoparalleltest
+ *      ./neoparalleltest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <stdlib.h>
+#include <string.h>
+#include "NeoParallel.h"
+#include "NeoTest.h"
+
+#define LANES   5       // fewer than NEO_MAX_LANES, so the unused lanes are padded too
+
+// bit k of out[j] is bit (7 - j) of in[k], one bit at a time
+static void naiveTranspose(const uint8_t *in, uint8_t *out)
+{
+    for (int j = 0; j < 8; j++)
+    {
+        out[j] = 0;
+        for (int k = 0; k < 8; k++)
+            if (in[k] & (0x80 >> j))
+                out[j] |= 1 << k;
+    }
+}
+
+static void checkTranspose8(const uint8_t *in)
+{
+    uint8_t out[8], expect[8];
+    naiveTranspose(in, expect);
+    neo_transpose8(in, out);
+    NEO_CHECK(memcmp(out, expect, 8) == 0, "in %02x %02x %02x %02x %02x %02x %02x %02x",
+              in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7]);
+}
+
+// compares every byte position NeoParallel sends with the lane bytes it must carry
+static void checkFrame(const char *name, const NeoParallel &parallel, const NeoColor *const *px, const int *size)
+{
+    int len = parallel.length();
+    for (int byte = 0; byte < len; byte++)
+    {
+        uint8_t in[8], out[8], expect[8];
+        for (int i = 0; i < 8; i++)
+            in[i] = (i < LANES && byte < size[i] * 3) ? ((const uint8_t*)px[i])[byte] : 0;
+        naiveTranspose(in, expect);
+        parallel.transpose(byte, out);
+        NEO_CHECK(memcmp(out, expect, 8) == 0, "%s: byte %d", name, byte);
+    }
+}
+
+int main()
+{
+    // every single bit, then random blocks
+    for (int k = 0; k < 8; k++)
+        for (int b = 0; b < 8; b++)
+        {
+            uint8_t in[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+            in[k] = 1 << b;
+            checkTranspose8(in);
+        }
+    srand(1);
+    for (int n = 0; n < 10000; n++)
+    {
+        uint8_t in[8];
+        for (int k = 0; k < 8; k++)
+            in[k] = rand() & 0xFF;
+        checkTranspose8(in);
+    }
+
+    // lanes of 64, 192, 1 and 128 pixels; lane 4 never writes a frame
+    static const int size[LANES] = {64, 192, 1, 128, 0};
+    static NeoColor frames[LANES][192];
+    const NeoColor *px[LANES];
+    for (int i = 0; i < LANES; i++)
+    {
+        uint8_t *p = (uint8_t*)frames[i];
+        for (int j = 0; j < (int)sizeof(frames[i]); j++)
+            p[j] = rand() & 0xFF;
+        px[i] = frames[i];
+    }
+
+    NeoParallel parallel(LANES);
+    for (int i = 0; i < LANES - 1; i++)
+        parallel.lane(i)->write(frames[i], size[i]);
+    NEO_CHECK(parallel.length() == 192 * 3, "length %d for the first frames", parallel.length());
+    checkFrame("first frames", parallel, px, size);
+    parallel.write();
+    NEO_CHECK(parallel.length() == 0, "length %d after write()", parallel.length());
+
+    // short changed prefixes still send the rest of each lane's chain
+    parallel.lane(0)->write(frames[0], 10);
+    parallel.lane(1)->write(frames[1], 2);
+    NEO_CHECK(parallel.length() == 10 * 3, "length %d for the changed prefixes", parallel.length());
+    checkFrame("changed prefixes", parallel, px, size);
+
+    return neo_test_done("NeoParallelTest");
+}
+
+#endif
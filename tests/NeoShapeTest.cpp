@@ -0,0 +1,330 @@
+/**********************************************
+ * NeoShapeTest.cpp
+ *
+ *  Golden image test for the ellipse and arc primitives of NeoArr. Each shape
+ *  is drawn on one board of a 2x2 grid, where nothing may spill onto the other
+ *  boards, or across the whole canvas with NEO_CANVAS. The canvas is compared
+ *  with the expected image below, drawn as text with the top row first, '#'
+ *  for a lit pixel and '.' for an unlit one.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoShapeTest.cpp NeoMatrix/Neo*.cpp -o neoshapetest
+ *      ./neoshapetest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <string.h>
+#include "NeoMatrix.h"
+#include "NeoTest.h"
+
+#define SHAPES  13
+
+static NeoNullSink nullSink;
+
+// gives the test the pixel buffer
+class PixelArr : public NeoArr
+{
+    public:
+        PixelArr(int N) : NeoArr(&nullSink, N) {}
+        bool lit(int i) const { return arr[i].red || arr[i].green || arr[i].blue; }
+};
+
+static const char *names[SHAPES] = {
+    "ellipse",
+    "filled ellipse",
+    "clipped ellipse",
+    "arc",
+    "filled arc",
+    "clipped arc",
+    "board ellipse",
+    "canvas ellipse",
+    "canvas filled ellipse",
+    "canvas clipped ellipse",
+    "canvas arc",
+    "canvas filled arc",
+    "canvas clipped arc",
+};
+
+static const char *golden[SHAPES][16] = {
+    {   // rx 3, ry 2 about (3, 4) on board 0, the bottom left one
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "..###...........",
+        ".#...#..........",
+        "#.....#.........",
+        ".#...#..........",
+        "..###...........",
+        "................",
+        "................",
+    },
+    {   // rx 3, ry 2 about (3, 4) filled, on board 3, the top right one
+        "................",
+        "..........###...",
+        ".........#####..",
+        "........#######.",
+        ".........#####..",
+        "..........###...",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+    },
+    {   // rx 5, ry 4 about (6, 1) on board 2, clipped at its right and bottom edges
+        "................",
+        "................",
+        "....####........",
+        "...#............",
+        "..#.............",
+        ".#..............",
+        ".#..............",
+        ".#..............",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+    },
+    {   // r 3 about (3, 3) on board 0 from 30 to 200 degrees
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "..###...........",
+        ".#...#..........",
+        "#...............",
+        "#...............",
+        "#...............",
+        "................",
+        "................",
+    },
+    {   // a slice of r 3 about (3, 4) on board 3 from 300 degrees round through 0 to 60
+        "................",
+        ".............#..",
+        "............###.",
+        "...........####.",
+        "............###.",
+        ".............#..",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+    },
+    {   // r 5 about (1, 6) on board 2 from 90 to 360 degrees, clipped at its left and top
+        "................",
+        "......#.........",
+        "......#.........",
+        "......#.........",
+        ".....#..........",
+        "....#...........",
+        "####............",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+    },
+    {   // on board 1, the bottom right one, clipped at its left edge
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+        "........###.....",
+        "........#####...",
+        "........######..",
+        "........######..",
+        "........######..",
+        "........#####...",
+        "........###.....",
+        "................",
+    },
+    {   // rx 6, ry 3 about (7, 8), across all four boards
+        "................",
+        "................",
+        "................",
+        "................",
+        "....#######.....",
+        "..##.......##...",
+        ".#...........#..",
+        ".#...........#..",
+        ".#...........#..",
+        "..##.......##...",
+        "....#######.....",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+    },
+    {   // the same ellipse filled
+        "................",
+        "................",
+        "................",
+        "................",
+        "....#######.....",
+        "..###########...",
+        ".#############..",
+        ".#############..",
+        ".#############..",
+        "..###########...",
+        "....#######.....",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+    },
+    {   // rx 7, ry 9 about (12, 4), clipped at the right and bottom of the canvas
+        "................",
+        "................",
+        "..........#####.",
+        ".........#.....#",
+        "........#.......",
+        ".......#........",
+        "......#.........",
+        "......#.........",
+        ".....#..........",
+        ".....#..........",
+        ".....#..........",
+        ".....#..........",
+        ".....#..........",
+        ".....#..........",
+        ".....#..........",
+        "......#.........",
+    },
+    {   // r 6 about (7, 7) from 30 to 200 degrees
+        "................",
+        "................",
+        ".....#####......",
+        "....#.....#.....",
+        "...#.......#....",
+        "..#.........#...",
+        ".#..............",
+        ".#..............",
+        ".#..............",
+        ".#..............",
+        ".#..............",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+    },
+    {   // a slice from 300 degrees round through 0 to 60
+        "................",
+        "................",
+        "................",
+        "..........#.....",
+        "..........##....",
+        ".........####...",
+        ".........#####..",
+        "........######..",
+        ".......#######..",
+        "........######..",
+        ".........#####..",
+        ".........####...",
+        "..........##....",
+        "..........#.....",
+        "................",
+        "................",
+    },
+    {   // r 7 about (3, 12) from 90 to 360 degrees, clipped at the left and top
+        "................",
+        "................",
+        "................",
+        "..........#.....",
+        "..........#.....",
+        "..........#.....",
+        ".........#......",
+        ".........#......",
+        "........#.......",
+        "#.....##........",
+        ".#####..........",
+        "................",
+        "................",
+        "................",
+        "................",
+        "................",
+    },
+};
+
+static void draw(PixelArr &a, int shape)
+{
+    switch (shape)
+    {
+        case 0: a.drawEllipse(0, 3, 4, 3, 2, 0xFFFFFF); break;
+        case 1: a.drawFilledEllipse(3, 3, 4, 3, 2, 0xFFFFFF); break;
+        case 2: a.drawEllipse(2, 6, 1, 5, 4, 0xFFFFFF); break;
+        case 3: a.drawArc(0, 3, 3, 3, 30, 200, 0xFFFFFF); break;
+        case 4: a.drawFilledArc(3, 3, 4, 3, 300, 60, 0xFFFFFF); break;
+        case 5: a.drawArc(2, 1, 6, 5, 90, 360, 0xFFFFFF); break;
+        case 6: a.drawFilledEllipse(1, 0, 4, 5, 3, 0xFFFFFF); break;
+        case 7: a.drawEllipse(NEO_CANVAS, 7, 8, 6, 3, 0xFFFFFF); break;
+        case 8: a.drawFilledEllipse(NEO_CANVAS, 7, 8, 6, 3, 0xFFFFFF); break;
+        case 9: a.drawEllipse(NEO_CANVAS, 12, 4, 7, 9, 0xFFFFFF); break;
+        case 10: a.drawArc(NEO_CANVAS, 7, 7, 6, 30, 200, 0xFFFFFF); break;
+        case 11: a.drawFilledArc(NEO_CANVAS, 7, 7, 6, 300, 60, 0xFFFFFF); break;
+        case 12: a.drawArc(NEO_CANVAS, 3, 12, 7, 90, 360, 0xFFFFFF); break;
+    }
+}
+
+int main()
+{
+    NeoLayout grid(2, 2);
+    for (int s = 0; s < SHAPES; s++)
+    {
+        PixelArr a(4);
+        a.setLayout(grid);
+        draw(a, s);
+
+        for (int y = 15; y >= 0; y--)
+        {
+            char row[17];
+            for (int x = 0; x < 16; x++)
+                row[x] = a.lit(grid.index(x, y)) ? '#' : '.';
+            row[16] = 0;
+            NEO_CHECK(strcmp(row, golden[s][15 - y]) == 0, "%s: row y = %d is %s, expected %s",
+                      names[s], y, row, golden[s][15 - y]);
+        }
+    }
+
+    return neo_test_done("NeoShapeTest");
+}
+
+#endif
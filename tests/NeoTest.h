@@ -0,0 +1,42 @@
+/**
+ * NeoTest.h
+ *
+ * The few lines of harness the host tests share. Each test is a program of its
+ * own that prints the checks that fail and exits non zero if any did, e.g.
+ *
+ *     NEO_CHECK(map[9] == 14, "tile 1 column 1 row 1 at %d", map[9]);
+ *     return neo_test_done("NeoLayoutTest");
+ *
+ */
+
+#ifndef NEOTEST_H
+#define NEOTEST_H
+
+#include <stdio.h>
+
+static int neo_test_checks = 0;
+static int neo_test_failures = 0;
+
+// counts a check and prints the message if it failed
+#define NEO_CHECK(cond, ...) \
+    do { \
+        neo_test_checks++; \
+        if (!(cond)) \
+        { \
+            if (neo_test_failures++ < 20) \
+            { \
+                printf("%s:%d: FAILED %s: ", __FILE__, __LINE__, #cond); \
+                printf(__VA_ARGS__); \
+                printf("\n"); \
+            } \
+        } \
+    } while (0)
+
+// prints the summary line and returns the exit code for main()
+static int neo_test_done(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, neo_test_checks, neo_test_failures);
+    return neo_test_failures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,129 @@
+/**********************************************
+ * NeoTextTest.cpp
+ *
+ *  Host test for NeoArr::drawText() and drawChar(). Text is drawn at every
+ *  position from well off one edge of the area to well off the other and
+ *  compared pixel for pixel with a reference that plots each font column bit
+ *  and checks its bounds, on a board in the middle of a row and on a 2x2 board
+ *  canvas.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoTextTest.cpp NeoMatrix/Neo*.cpp -o neotexttest
+ *      ./neotexttest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <string.h>
+#include "NeoMatrix.h"
+#include "NeoTest.h"
+
+#define TEXT    "Hi, \xC3\x84g!"     // "Hi, Äg!" with a descender and a Latin-1 letter
+
+static NeoNullSink nullSink;
+
+// gives the test the pixel buffer
+class PixelArr : public NeoArr
+{
+    public:
+        PixelArr(int N) : NeoArr(&nullSink, N) {}
+        bool lit(int i) const { return arr[i].red || arr[i].green || arr[i].blue; }
+};
+
+// marks the pixels of text at (x, y) inside a w by h area
+static void reference(bool *lit, int w, int h, int x, int y, const char *text)
+{
+    uint32_t c = neo_utf8_next(text);
+    while (c)
+    {
+        uint32_t next = neo_utf8_next(text);
+        const NeoGlyph &g = neo_font_glyph(neo_font_plain, c);
+        for (int j = 0; j < g.width; j++)
+        {
+            uint32_t bits = neo_font_column(neo_font_plain, g, j);
+            for (int b = 0; b < neo_font_plain.height; b++)
+            {
+                int px = x + g.left + j;
+                int py = y + b;
+                if ((bits >> b) & 1 && px >= 0 && px < w && py >= 0 && py < h)
+                    lit[px*h + py] = true;
+            }
+        }
+        x += g.advance;
+        if (next)
+            x += neo_font_kern(neo_font_plain, c, next);
+        c = next;
+    }
+}
+
+// marks the pixels of a font.h character at (x, y) inside a w by h area
+static void referenceChar(bool *lit, int w, int h, int x, int y, char c)
+{
+    const uint8_t *glyph = neo_glyph(c);
+    for (int j = 0; j < 6; j++)
+        for (int i = 0; i < 8; i++)
+        {
+            int px = x + j;
+            int py = y + 7 - i;     // bit 0 of a font.h column is the top row
+            if ((glyph[j] >> i) & 1 && px >= 0 && px < w && py >= 0 && py < h)
+                lit[px*h + py] = true;
+        }
+}
+
+// draws the text at every position from x0 to x1 and y0 to y1 on idx and compares
+// with the reference; chain[x*h + y] is the chain index of pixel (x, y) of the area
+static void check(const char *name, PixelArr &a, int idx, int w, int h, const int *chain, int n,
+                  int x0, int x1, int y0, int y1)
+{
+    static bool lit[16*16];
+    for (int x = x0; x <= x1; x++)
+        for (int y = y0; y <= y1; y++)
+        {
+            a.clear();
+            int end = a.drawText(idx, x, y, TEXT, neo_font_plain, 0xFFFFFF);
+            a.drawChar(idx, x + 2, y - 3, 'W', 0xFFFFFF);
+
+            memset(lit, 0, sizeof(lit));
+            reference(lit, w, h, x, y, TEXT);
+            referenceChar(lit, w, h, x + 2, y - 3, 'W');
+
+            int count = 0;
+            bool ok = true;
+            for (int i = 0; i < w*h; i++)
+            {
+                if (lit[i] != a.lit(chain[i]))
+                    ok = false;
+                count += lit[i];
+            }
+            for (int i = 0; i < n; i++)     // nothing outside the area
+                count -= a.lit(i);
+            NEO_CHECK(ok && count == 0, "%s: text at (%d, %d)", name, x, y);
+            NEO_CHECK(end == x + neo_text_width(neo_font_plain, TEXT), "%s: pen ends at %d", name, end);
+        }
+}
+
+int main()
+{
+    static int chain[16*16];
+    int width = neo_text_width(neo_font_plain, TEXT);
+
+    // board 1 of a row of 3, so text that is not clipped would reach its neighbours
+    PixelArr row(3);
+    for (int x = 0; x < 8; x++)
+        for (int y = 0; y < 8; y++)
+            chain[x*8 + y] = 64 + x*8 + y;
+    check("board", row, 1, 8, 8, chain, 3*64, -width - 2, 10, -10, 10);
+
+    NeoLayout grid(2, 2);
+    PixelArr canvas(4);
+    canvas.setLayout(grid);
+    for (int x = 0; x < 16; x++)
+        for (int y = 0; y < 16; y++)
+            chain[x*16 + y] = grid.index(x, y);
+    check("canvas", canvas, NEO_CANVAS, 16, 16, chain, 4*64, -width - 2, 18, -10, 18);
+
+    return neo_test_done("NeoTextTest");
+}
+
+#endif
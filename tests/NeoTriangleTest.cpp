@@ -0,0 +1,161 @@
+/**********************************************
+ * NeoTriangleTest.cpp
+ *
+ *  Host test for NeoArr::drawFilledTriangle(). Random triangles around a board
+ *  are compared pixel for pixel with a brute-force test of every pixel centre
+ *  against the three edges, and triangles that share an edge must split the
+ *  pixels on it between them, so a mesh covers every pixel exactly once.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -std=c++11 -INeoMatrix tests/NeoTriangleTest.cpp NeoMatrix/Neo*.cpp -o neotriangletest
+ *      ./neotriangletest
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <stdlib.h>
+#include <string.h>
+#include "NeoMatrix.h"
+#include "NeoTest.h"
+
+static NeoNullSink nullSink;
+
+// gives the test the pixel buffer
+class PixelArr : public NeoArr
+{
+    public:
+        PixelArr(int N) : NeoArr(&nullSink, N) {}
+        bool lit(int i) const { return arr[i].red || arr[i].green || arr[i].blue; }
+};
+
+// board 1 of a row of 3, so a triangle that is not clipped would reach its neighbours
+static PixelArr row(3);
+
+// side of (x, y) from the edge p to q: > 0 on the left, 0 on the edge
+static int side(int px, int py, int qx, int qy, int x, int y)
+{
+    return (qx - px) * (y - py) - (qy - py) * (x - px);
+}
+
+// true if a centre on the counter clockwise edge p to q belongs to its triangle:
+// edges running towards +x keep it, as do edges running straight down
+static bool keeps(int px, int py, int qx, int qy)
+{
+    return qx > px || (qx == px && qy < py);
+}
+
+// marks the pixels whose centres are inside the triangle, testing each one
+static void reference(bool *lit, int x1, int y1, int x2, int y2, int x3, int y3)
+{
+    memset(lit, 0, 64 * sizeof(bool));
+    int area = side(x1, y1, x2, y2, x3, y3);
+    if (area == 0)
+        return;
+    if (area < 0)
+    {
+        int t = x2; x2 = x3; x3 = t;
+        t = y2; y2 = y3; y3 = t;
+    }
+
+    int px[3] = {x1, x2, x3};
+    int py[3] = {y1, y2, y3};
+    for (int x = 0; x < 8; x++)
+        for (int y = 0; y < 8; y++)
+        {
+            bool in = true;
+            for (int i = 0; i < 3; i++)
+            {
+                int j = (i + 1) % 3;
+                int s = side(px[i], py[i], px[j], py[j], x, y);
+                if (s < 0 || (s == 0 && !keeps(px[i], py[i], px[j], py[j])))
+                    in = false;
+            }
+            lit[x*8 + y] = in;
+        }
+}
+
+// draws the triangle on board 1 and reads back its pixels; false if it drew
+// anything on the boards either side
+static bool draw(bool *lit, int x1, int y1, int x2, int y2, int x3, int y3)
+{
+    row.clear();
+    row.drawFilledTriangle(1, x1, y1, x2, y2, x3, y3, 0xFFFFFF);
+    for (int i = 0; i < 64; i++)
+        lit[i] = row.lit(64 + i);
+    for (int i = 0; i < 64; i++)
+        if (row.lit(i) || row.lit(128 + i))
+            return false;
+    return true;
+}
+
+static int between(int lo, int hi)
+{
+    return lo + rand() % (hi - lo + 1);
+}
+
+int main()
+{
+    bool lit[64], expect[64];
+    srand(1);
+
+    // random triangles reaching 6 pixels past each edge of the board
+    for (int n = 0; n < 20000; n++)
+    {
+        int x1 = between(-6, 13), y1 = between(-6, 13);
+        int x2 = between(-6, 13), y2 = between(-6, 13);
+        int x3 = between(-6, 13), y3 = between(-6, 13);
+        bool clipped = draw(lit, x1, y1, x2, y2, x3, y3);
+        reference(expect, x1, y1, x2, y2, x3, y3);
+        NEO_CHECK(clipped && memcmp(lit, expect, sizeof(lit)) == 0, "triangle (%d, %d) (%d, %d) (%d, %d)", x1, y1, x2, y2, x3, y3);
+    }
+
+    // a square around the board cut into 4 triangles at p: every pixel once
+    int cx[4] = {-1, 8, 8, -1};
+    int cy[4] = {-1, -1, 8, 8};
+    for (int px = -1; px <= 8; px++)
+        for (int py = -1; py <= 8; py++)
+        {
+            int count[64];
+            memset(count, 0, sizeof(count));
+            for (int i = 0; i < 4; i++)
+            {
+                int j = (i + 1) % 4;
+                draw(lit, cx[i], cy[i], cx[j], cy[j], px, py);
+                for (int k = 0; k < 64; k++)
+                    count[k] += lit[k];
+            }
+            bool once = true;
+            for (int k = 0; k < 64; k++)
+                if (count[k] != 1)
+                    once = false;
+            NEO_CHECK(once, "square cut at (%d, %d)", px, py);
+        }
+
+    // random pairs on either side of a shared edge never write the same pixel,
+    // and together they cover what the reference gives for each
+    for (int n = 0; n < 20000; n++)
+    {
+        int ax = between(-4, 11), ay = between(-4, 11);
+        int bx = between(-4, 11), by = between(-4, 11);
+        int cx = between(-4, 11), cy = between(-4, 11);
+        int dx = between(-4, 11), dy = between(-4, 11);
+        if ((long)side(ax, ay, bx, by, cx, cy) * side(ax, ay, bx, by, dx, dy) >= 0)
+            continue;       // c and d must be on opposite sides
+
+        bool first[64], second[64], expectFirst[64], expectSecond[64];
+        draw(first, ax, ay, bx, by, cx, cy);
+        draw(second, bx, by, ax, ay, dx, dy);
+        reference(expectFirst, ax, ay, bx, by, cx, cy);
+        reference(expectSecond, bx, by, ax, ay, dx, dy);
+        bool ok = true;
+        for (int k = 0; k < 64; k++)
+            if ((first[k] && second[k]) || (first[k] || second[k]) != (expectFirst[k] || expectSecond[k]))
+                ok = false;
+        NEO_CHECK(ok, "edge (%d, %d) (%d, %d) between (%d, %d) and (%d, %d)", ax, ay, bx, by, cx, cy, dx, dy);
+    }
+
+    return neo_test_done("NeoTriangleTest");
+}
+
+#endif
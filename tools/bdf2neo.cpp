@@ -0,0 +1,311 @@
+/**********************************************
+ * bdf2neo.cpp
+ *
+ *  Host tool that converts a BDF bitmap font into the packed NeoFont tables of
+ *  NeoFont.h, written as a source file to add to the project.
+ *
+ *  Build and run on the host from the repository root:
+ *
+ *      g++ -O2 -INeoMatrix tools/bdf2neo.cpp NeoMatrix/NeoFont.cpp -o bdf2neo
+ *      ./bdf2neo font.bdf name [-r first last] [-k kerning.txt] > NeoFontName.cpp
+ *
+ *  name is the NeoFont the file defines; declare it elsewhere as
+ *  extern const NeoFont name. -r limits the characters to the code points
+ *  first..last (default every encoding in the font up to U+FFFF). The kerning
+ *  file has one pair per line, the two characters in UTF-8 then the columns to
+ *  add, e.g. "AV -1"; lines starting with # are skipped.
+ *
+ *  Glyphs are trimmed to their inked columns and placed in the font bounding box,
+ *  which must be at most NEO_FONT_MAX_HEIGHT rows high. The advance of each glyph
+ *  is its DWIDTH.
+ *
+ *  The glyph table is indexed directly from the lowest code point up to the
+ *  first gap of more than MAX_GAP missing characters, the gaps filled with the
+ *  fallback glyph. The characters after that are listed in a sorted table of
+ *  code points that NeoFont searches.
+ */
+
+#ifndef TARGET_LPC1768
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "NeoFont.h"
+
+#define MAX_GAP     32      // missing characters the directly indexed range can span
+
+// a glyph as read from the BDF file, column by column with bit 0 at the bottom
+struct Glyph
+{
+    int left;
+    int advance;
+    std::vector<uint32_t> columns;
+};
+
+struct Kern
+{
+    int left, right, adjust;
+    bool operator<(const Kern &k) const { return left != k.left ? left < k.left : right < k.right; }
+};
+
+static void fail(const char *msg, const char *arg)
+{
+    fprintf(stderr, "bdf2neo: %s%s\n", msg, arg);
+    exit(1);
+}
+
+// reads the glyphs of a BDF file into glyphs[encoding]; returns the font height
+static int readBdf(const char *path, std::map<int, Glyph> &glyphs, int &fallback)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        fail("unable to open ", path);
+
+    char line[1024];
+    int fh = 0, fy = 0;
+    int enc = -1, dx = 0, w = 0, h = 0, xo = 0, yo = 0;
+    fallback = -1;
+    while (fgets(line, sizeof(line), f))
+    {
+        int a, b, c, d;
+        if (sscanf(line, "FONTBOUNDINGBOX %d %d %d %d", &a, &b, &c, &d) == 4)
+        {
+            fh = b;
+            fy = d;
+        }
+        else if (sscanf(line, "DEFAULT_CHAR %d", &a) == 1)
+            fallback = a;
+        else if (sscanf(line, "ENCODING %d", &a) == 1)
+            enc = a;
+        else if (sscanf(line, "DWIDTH %d", &a) == 1)
+            dx = a;
+        else if (sscanf(line, "BBX %d %d %d %d", &a, &b, &c, &d) == 4)
+        {
+            w = a;
+            h = b;
+            xo = c;
+            yo = d;
+        }
+        else if (strncmp(line, "BITMAP", 6) == 0)
+        {
+            if (fh > NEO_FONT_MAX_HEIGHT)
+                fail("font is too tall for NeoFont: ", path);
+
+            // rows come top first, each a hex number with the leftmost pixel in the top bit
+            std::vector<uint32_t> columns(w, 0);
+            int bytes = (w + 7) / 8;
+            for (int r = 0; r < h && fgets(line, sizeof(line), f); r++)
+            {
+                int y = (yo - fy) + (h - 1 - r);    // row up from the bottom of the font box
+                if (y < 0 || y >= fh)
+                    continue;
+                for (int c = 0; c < w && c / 8 < bytes; c++)
+                {
+                    unsigned v;
+                    char hex[3] = {line[(c / 8) * 2], line[(c / 8) * 2 + 1], 0};
+                    if (sscanf(hex, "%x", &v) != 1)
+                        break;
+                    if (v & (0x80 >> (c % 8)))
+                        columns[c] |= 1 << y;
+                }
+            }
+
+            if (enc >= 0 && enc <= 0xFFFF)
+            {
+                // trim the blank columns on either side
+                int first = 0, last = w - 1;
+                while (first <= last && columns[first] == 0)
+                    first++;
+                while (last >= first && columns[last] == 0)
+                    last--;
+                Glyph &g = glyphs[enc];
+                g.advance = dx;
+                g.left = (first <= last) ? xo + first : 0;
+                g.columns.assign(columns.begin() + first, columns.begin() + last + 1);
+            }
+            enc = -1;
+        }
+    }
+    fclose(f);
+    if (fh == 0)
+        fail("no FONTBOUNDINGBOX in ", path);
+    return fh;
+}
+
+// decodes one UTF-8 character and moves s past it
+static int utf8(const char *&s)
+{
+    const char *p = s;
+    uint32_t c = neo_utf8_next(p);
+    s = p;
+    return c;
+}
+
+static std::vector<Kern> readKerning(const char *path)
+{
+    std::vector<Kern> kerns;
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        fail("unable to open ", path);
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+        Kern k;
+        if (line[0] == '#' || strlen(line) < 4)
+            continue;
+        const char *p = line;
+        k.left = utf8(p);
+        k.right = utf8(p);
+        if (k.left > 0xFFFF || k.right > 0xFFFF)
+            fail("kerning pair beyond U+FFFF in ", path);
+        k.adjust = atoi(p);
+        kerns.push_back(k);
+    }
+    fclose(f);
+    std::sort(kerns.begin(), kerns.end());
+    return kerns;
+}
+
+static void printChar(int c)
+{
+    if (c >= ' ' && c < 127 && c != '\\' && c != '\'')
+        printf("'%c'", c);
+    else
+        printf("0x%04x", c);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: bdf2neo font.bdf name [-r first last] [-k kerning.txt]\n");
+        return 1;
+    }
+    const char *name = argv[2];
+    int first = 0, last = 0xFFFF;
+    std::vector<Kern> kerns;
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 2 < argc)
+        {
+            first = strtol(argv[++i], NULL, 0);
+            last = strtol(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+            kerns = readKerning(argv[++i]);
+        else
+            fail("unknown option ", argv[i]);
+    }
+
+    std::map<int, Glyph> all;
+    int fallback;
+    int height = readBdf(argv[1], all, fallback);
+
+    // the characters in range, in code point order
+    std::vector<int> codes;
+    for (std::map<int, Glyph>::iterator g = all.begin(); g != all.end(); ++g)
+        if (g->first >= first && g->first <= last)
+            codes.push_back(g->first);
+    if (codes.empty())
+        fail("no characters in range in ", argv[1]);
+    if (!std::binary_search(codes.begin(), codes.end(), fallback))
+        fallback = std::binary_search(codes.begin(), codes.end(), (int)'?') ? '?' : codes[0];
+
+    // index directly up to the first wide gap, then list the rest
+    size_t dense = 1;
+    while (dense < codes.size() && codes[dense] - codes[dense - 1] - 1 <= MAX_GAP)
+        dense++;
+    first = codes[0];
+    last = codes[dense - 1];
+    std::vector<int> sparse(codes.begin() + dense, codes.end());
+
+    // pack the columns of every glyph into one bit stream
+    std::vector<uint8_t> bits;
+    std::map<int, int> offset;
+    uint32_t at = 0;
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+        const Glyph &g = all[codes[i]];
+        offset[codes[i]] = at;
+        for (size_t k = 0; k < g.columns.size(); k++)
+            for (int y = 0; y < height; y++, at++)
+            {
+                if ((at >> 3) >= bits.size())
+                    bits.push_back(0);
+                if (g.columns[k] & (1 << y))
+                    bits[at >> 3] |= 1 << (at & 7);
+            }
+    }
+    if (at > 0xFFFF)
+        fail("too many glyph bits for NeoGlyph offsets in ", argv[1]);
+    bits.push_back(0);      // neo_font_column() reads up to two bytes past a column
+    bits.push_back(0);
+
+    printf("/**********************************************\n");
+    printf(" * %s\n", name);
+    printf(" *\n");
+    printf(" *  Generated by tools/bdf2neo from %s; do not edit.\n", argv[1]);
+    printf(" */\n\n");
+    printf("#include \"NeoFont.h\"\n\n");
+
+    printf("static const uint8_t %s_bitmap[%d] = {", name, (int)bits.size());
+    for (size_t i = 0; i < bits.size(); i++)
+        printf("%s0x%02x,", (i % 12) ? " " : "\n    ", bits[i]);
+    printf("\n};\n\n");
+
+    // glyphs first to last, then one for each listed code point
+    std::vector<int> order;
+    for (int c = first; c <= last; c++)
+        order.push_back(c);
+    order.insert(order.end(), sparse.begin(), sparse.end());
+    printf("static const NeoGlyph %s_glyphs[%d] = {\n", name, (int)order.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        int c = order[i];
+        int g = all.count(c) ? c : fallback;
+        printf("    {%5d, %2d, %2d, %2d},     // ", offset[g], (int)all[g].columns.size(), all[g].left, all[g].advance);
+        printChar(c);
+        printf("\n");
+    }
+    printf("};\n\n");
+
+    if (!sparse.empty())
+    {
+        printf("static const uint16_t %s_codes[%d] = {", name, (int)sparse.size());
+        for (size_t i = 0; i < sparse.size(); i++)
+            printf("%s0x%04x,", (i % 8) ? " " : "\n    ", sparse[i]);
+        printf("\n};\n\n");
+    }
+
+    if (!kerns.empty())
+    {
+        printf("static const NeoKern %s_kerning[%d] = {\n", name, (int)kerns.size());
+        for (size_t i = 0; i < kerns.size(); i++)
+        {
+            printf("    {");
+            printChar(kerns[i].left);
+            printf(", ");
+            printChar(kerns[i].right);
+            printf(", %d},\n", kerns[i].adjust);
+        }
+        printf("};\n\n");
+    }
+
+    printf("extern const NeoFont %s;\n", name);
+    printf("const NeoFont %s = {%s_bitmap, %s_glyphs, ", name, name, name);
+    if (sparse.empty())
+        printf("NULL, 0, ");
+    else
+        printf("%s_codes, %d, ", name, (int)sparse.size());
+    if (kerns.empty())
+        printf("NULL, 0, ");
+    else
+        printf("%s_kerning, %d, ", name, (int)kerns.size());
+    printf("0x%04x, 0x%04x, 0x%04x, %d};\n", first, last, fallback, height);
+    return 0;
+}
+
+#endif